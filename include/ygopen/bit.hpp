@@ -37,6 +37,34 @@ template<typename T>
 #endif
 }
 
+// Counts the number of consecutive 0 bits in `x`, starting from the least
+// significant bit. Yields the number of bits of `T` if `x` is 0.
+template<typename T>
+[[nodiscard]] constexpr auto ctz(T x) noexcept -> unsigned
+{
+	static_assert(std::is_unsigned_v<T>);
+#if defined(__cpp_lib_bitops)
+	return static_cast<unsigned>(std::countr_zero(x));
+#elif defined(__GNUC__) || defined(__clang__)
+	if(x == 0U)
+		return std::numeric_limits<T>::digits;
+	if constexpr(std::numeric_limits<T>::digits > 32)
+		return static_cast<unsigned>(__builtin_ctzll(x));
+	else
+		return static_cast<unsigned>(__builtin_ctz(x));
+#else
+	if(x == 0U)
+		return std::numeric_limits<T>::digits;
+	unsigned count = 0;
+	while((x & 1U) == 0U)
+	{
+		count++;
+		x >>= 1U;
+	}
+	return count;
+#endif
+}
+
 // Chooses at most `count` 1 bits from `x`, starting from the most significant
 // bit.
 template<typename T>
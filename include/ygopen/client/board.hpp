@@ -7,6 +7,8 @@
 #define YGOPEN_CLIENT_BOARD_HPP
 #include <array>
 #include <cassert>
+#include <cstdint>
+#include <ygopen/client/state_hash.hpp>
 #include <ygopen/detail/config.hpp>
 #include <ygopen/duel/constants/controller.hpp>
 
@@ -89,6 +91,24 @@ public:
 		return blocked_zones_;
 	}
 
+	// Hash of the whole state of the board, for checking that two boards are
+	// the same. Requires a frame that keeps its own hash (see HashedFrame),
+	// the rest of the values are few and hashed on each call.
+	// NOTE: Inherits the frame's blind spots, with HashedFrame card values
+	// written without going through `card_update`.
+	[[nodiscard]] constexpr auto state_hash() const noexcept -> uint64_t
+	{
+		using namespace Detail;
+		uint64_t h = hash_mix(frame_.state_hash());
+		h = hash_combine(h, hash_value(chain_stack_));
+		h = hash_combine(h, hash_value(turn_));
+		h = hash_combine(h, hash_value(turn_controller_));
+		h = hash_combine(h, hash_value(lp_[0U]));
+		h = hash_combine(h, hash_value(lp_[1U]));
+		h = hash_combine(h, hash_value(phase_));
+		return hash_combine(h, hash_value(blocked_zones_));
+	}
+
 	// Non-const getters.
 
 	[[nodiscard]] constexpr auto frame() noexcept -> FrameType&
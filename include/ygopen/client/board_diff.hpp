@@ -0,0 +1,526 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_CLIENT_BOARD_DIFF_HPP
+#define YGOPEN_CLIENT_BOARD_DIFF_HPP
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <ygopen/client/frame.hpp>
+#include <ygopen/client/parse_query.hpp>
+#include <ygopen/client/state_hash.hpp>
+#include <ygopen/client/value_types.hpp>
+#include <ygopen/duel/constants/controller.hpp>
+#include <ygopen/duel/constants/phase.hpp>
+#include <ygopen/proto/duel/msg.hpp>
+
+namespace YGOpen::Client
+{
+
+namespace Detail
+{
+
+template<typename Q, typename T>
+auto set_query_value(Q& q, T const& v) noexcept -> void
+{
+	using P = std::remove_cv_t<std::remove_reference_t<decltype(q.value())>>;
+	if constexpr(std::is_arithmetic_v<P>)
+		q.set_value(static_cast<P>(static_cast<ValueTypeOrT<T>>(v)));
+	else
+		to_proto(v, *q.mutable_value());
+}
+
+// Fills `data` with the values of `card` that differ from `prev`'s, or from
+// default values if there is no `prev`. Returns whether any was filled.
+template<typename Card, typename PrevCard>
+auto diff_query(Card const& card, PrevCard const* prev,
+                Proto::Duel::Msg::Query::Data& data) noexcept -> bool
+{
+	bool filled = false;
+	auto differs = [prev](auto const& v, auto get) -> bool
+	{
+		using T = std::remove_cv_t<std::remove_reference_t<decltype(v)>>;
+		auto const h = (prev != nullptr) ? hash_value(get(*prev))
+		                                 : hash_value(T{});
+		return h != hash_value(v);
+	};
+#define X(NAME, Name, name, value)                                  \
+	if(differs(card.name(), [](auto const& c) -> auto const&        \
+	           { return c.name(); }))                               \
+	{                                                               \
+		set_query_value(*data.mutable_##name(), card.name());       \
+		filled = true;                                              \
+	}
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef X
+	if(differs(card.counters(),
+	           [](auto const& c) -> auto const& { return c.counters(); }))
+	{
+		auto& values = *data.mutable_counters()->mutable_values();
+		for(auto const& v : card.counters())
+			to_proto(v, *values.Add());
+		filled = true;
+	}
+	if(differs(card.targets(),
+	           [](auto const& c) -> auto const& { return c.targets(); }))
+	{
+		auto& values = *data.mutable_targets()->mutable_values();
+		for(auto const& v : card.targets())
+			to_proto(v, *values.Add());
+		filled = true;
+	}
+	return filled;
+}
+
+// Finds what to do to each card of `from` for it to become `to`, and appends
+// it as messages. See `diff`.
+template<typename FrameFrom, typename FrameTo>
+class FrameDiff
+{
+public:
+	using Msgs = google::protobuf::RepeatedPtrField<Proto::Duel::Msg>;
+
+	FrameDiff(FrameFrom const& from, FrameTo const& to, Msgs& msgs) noexcept
+		: msgs_(&msgs)
+	{
+		CardValuesHasher hasher;
+		auto add_src = [&](PlaceValue p, CardFrom const& c)
+		{
+			src_.push_back({p, hasher(c), &c});
+		};
+		auto add_dst = [&](PlaceValue p, CardTo const& c)
+		{
+			dst_.push_back({p, hasher(c), &c});
+		};
+		for_each_card(from, add_src);
+		for_each_card(to, add_dst);
+	}
+
+	// Appends the card events, and fills `queries` with the ones that must be
+	// parsed after all of them.
+	auto run(google::protobuf::RepeatedPtrField<Proto::Duel::Msg::Query>&
+	             queries) noexcept -> void
+	{
+		match_cards_();
+		for(size_t s = 0U; s < src_.size(); s++)
+			model_.card_add(src_[s].place) = s;
+		for(size_t s = 0U; s < src_.size(); s++)
+		{
+			if(!used_[s])
+				remove_(locate_(s));
+		}
+		for(size_t d = 0U; d < dst_.size(); d++)
+		{
+			auto const& p = dst_[d].place;
+			if(is_pile(p))
+				d = place_in_pile_(d);
+			else if(p.oseq() < 0)
+				place_in_zone_(d);
+			else
+				place_as_material_(d);
+		}
+		for(size_t d = 0U; d < dst_.size(); d++)
+		{
+			auto const s = match_[d];
+			Proto::Duel::Msg::Query q;
+			auto const* prev = (s != NONE) ? src_[s].card : nullptr;
+			if(!diff_query(*dst_[d].card, prev, *q.mutable_data()))
+				continue;
+			to_proto(dst_[d].place, *q.mutable_place());
+			*queries.Add() = std::move(q);
+		}
+	}
+
+private:
+	static constexpr size_t NONE = SIZE_MAX;
+
+	template<typename Card>
+	struct Entry
+	{
+		PlaceValue place;
+		uint64_t key;
+		Card const* card;
+	};
+
+	using CardFrom = typename FrameFrom::CardType;
+	using CardTo = typename FrameTo::CardType;
+
+	Msgs* msgs_;
+	std::vector<Entry<CardFrom>> src_;
+	std::vector<Entry<CardTo>> dst_;
+	std::vector<size_t> match_; // Source card of each destination card.
+	std::vector<bool> used_; // Whether each source card is matched.
+	// Frame whose "cards" are the index of their source card, or NONE if new.
+	// Mirrors what the messages appended so far do to the `from` frame.
+	BasicFrame<size_t> model_;
+
+	// Matches destination cards with source cards, preferring the ones that
+	// need nothing done, then ones that only need to move, and then the ones
+	// that only need their values changed. The rest are added or removed.
+	auto match_cards_() noexcept -> void
+	{
+		match_.assign(dst_.size(), NONE);
+		used_.assign(src_.size(), false);
+		std::unordered_map<PlaceValue, size_t> by_place;
+		std::unordered_map<uint64_t, std::vector<size_t>> by_key;
+		for(size_t s = src_.size(); s-- != 0U;)
+		{
+			by_place.emplace(src_[s].place, s);
+			by_key[src_[s].key].push_back(s);
+		}
+		auto use = [&](size_t d, size_t s)
+		{
+			match_[d] = s;
+			used_[s] = true;
+		};
+		for(size_t d = 0U; d < dst_.size(); d++)
+		{
+			auto it = by_place.find(dst_[d].place);
+			if(it != by_place.end() && src_[it->second].key == dst_[d].key)
+				use(d, it->second);
+		}
+		for(size_t d = 0U; d < dst_.size(); d++)
+		{
+			if(match_[d] != NONE)
+				continue;
+			auto it = by_key.find(dst_[d].key);
+			if(it == by_key.end())
+				continue;
+			auto& candidates = it->second;
+			while(!candidates.empty() && used_[candidates.back()])
+				candidates.pop_back();
+			if(candidates.empty())
+				continue;
+			use(d, candidates.back());
+			candidates.pop_back();
+		}
+		for(size_t d = 0U; d < dst_.size(); d++)
+		{
+			if(match_[d] != NONE)
+				continue;
+			auto it = by_place.find(dst_[d].place);
+			if(it != by_place.end() && !used_[it->second])
+				use(d, it->second);
+		}
+	}
+
+	// Where the source card `s` is now.
+	// NOTE: Linear, but boards have no more than a few hundred cards.
+	auto locate_(size_t s) const noexcept -> PlaceValue
+	{
+		PlaceValue found{};
+		auto find = [&](PlaceValue p, size_t token)
+		{
+			if(token == s)
+				found = p;
+		};
+		for_each_card(model_, find);
+		assert(!is_empty(found));
+		return found;
+	}
+
+	// Pile where cards in the way are left until they are taken to where
+	// they go, at the end so that nothing else moves.
+	auto aside_(PlaceValue const& p) const noexcept -> PlaceValue
+	{
+		auto const con = get_con(p);
+		auto const loc = YGOpen::Duel::LOCATION_MAIN_DECK;
+		auto const seq = static_cast<uint32_t>(model_.pile(con, loc).size());
+		return {con, loc, seq, Proto::Duel::OSEQ_INVALID};
+	}
+
+	auto place_in_zone_(size_t d) noexcept -> void
+	{
+		auto const& p = dst_[d].place;
+		auto const s = match_[d];
+		auto const* current = model_.zone(p).card;
+		if(current != nullptr && *current == s && s != NONE)
+			return;
+		// NOTE: Cards in other zones are swapped in, materials included, as
+		// materials are placed after every zone card.
+		PlaceValue from{};
+		if(s != NONE)
+			from = locate_(s);
+		bool const from_zone = s != NONE && !is_pile(from) && from.oseq() < 0;
+		if(current != nullptr && from_zone)
+		{
+			swap_(from, p);
+			return;
+		}
+		if(current != nullptr)
+			move_(p, aside_(p));
+		if(s == NONE)
+		{
+			add_(p);
+			return;
+		}
+		if(from_zone && !model_.zone(p).materials.empty())
+		{
+			auto const aside = aside_(from);
+			move_(from, aside);
+			from = aside;
+		}
+		move_(from, p);
+	}
+
+	auto place_as_material_(size_t d) noexcept -> void
+	{
+		auto const& p = dst_[d].place;
+		auto const s = match_[d];
+		auto const& materials = model_.zone(p).materials;
+		auto const oseq = static_cast<size_t>(p.oseq());
+		if(oseq < materials.size() && *materials[oseq] == s && s != NONE)
+			return;
+		if(s == NONE)
+			add_(p);
+		else
+			move_(locate_(s), p);
+	}
+
+	// Places the destination card `d`, which is in a pile, and as many of the
+	// ones following it as can be done at once. Returns the last one placed.
+	auto place_in_pile_(size_t d) noexcept -> size_t
+	{
+		auto const& p = dst_[d].place;
+		auto const& pile = model_.pile(p);
+		auto const s = match_[d];
+		// Amount of destination cards from `i` onwards that are in the same
+		// order in the pile at `from`.
+		auto same_from = [&](size_t i, PlaceValue const& from) -> size_t
+		{
+			size_t count = 0U;
+			auto const& src_pile = model_.pile(from);
+			auto const first = from.seq();
+			while(i + count < dst_.size() && first + count < src_pile.size())
+			{
+				if(!same_pile_(dst_[i + count].place, p))
+					break;
+				auto const ns = match_[i + count];
+				if(ns == NONE || *src_pile[first + count] != ns)
+					break;
+				count++;
+			}
+			return count;
+		};
+		if(s == NONE)
+		{
+			// New cards with default values are added at once by growing
+			// the pile, if nothing is past where they go.
+			size_t count = 0U;
+			while(d + count < dst_.size() && match_[d + count] == NONE &&
+			      same_pile_(dst_[d + count].place, p) &&
+			      !needs_query_(d + count))
+				count++;
+			if(count > 1U && pile.size() == p.seq())
+			{
+				resize_(p, p.seq() + count);
+				return d + count - 1U;
+			}
+			add_(p);
+			return d;
+		}
+		auto const from = locate_(s);
+		if(is_pile(from))
+		{
+			auto const count = same_from(d, from);
+			assert(count != 0U);
+			if(same_pile_(from, p) && from.seq() == p.seq())
+				return d + count - 1U;
+			if(count > 1U)
+			{
+				splice_(from, count, p);
+				return d + count - 1U;
+			}
+		}
+		move_(from, p);
+		return d;
+	}
+
+	auto needs_query_(size_t d) const noexcept -> bool
+	{
+		Proto::Duel::Msg::Query::Data data;
+		return diff_query(*dst_[d].card, static_cast<CardFrom const*>(nullptr),
+		                  data);
+	}
+
+	static auto same_pile_(PlaceValue const& a, PlaceValue const& b) noexcept
+		-> bool
+	{
+		return a.con() == b.con() && a.loc() == b.loc() && is_pile(a) &&
+		       is_pile(b);
+	}
+
+	// Operations, done on the model and appended as messages. Consecutive
+	// operations of the same kind share a message.
+
+	auto event_() noexcept -> Proto::Duel::Msg::Event&
+	{
+		return *msgs_->Add()->mutable_event();
+	}
+
+	auto last_event_() noexcept -> Proto::Duel::Msg::Event*
+	{
+		if(msgs_->empty())
+			return nullptr;
+		return msgs_->Mutable(msgs_->size() - 1)->mutable_event();
+	}
+
+	auto card_(Proto::Duel::Msg::Event::Card::TCase t) noexcept
+		-> Proto::Duel::Msg::Event::Card&
+	{
+		auto* e = last_event_();
+		if(e == nullptr || !e->has_card() || e->card().t_case() != t)
+			e = &event_();
+		return *e->mutable_card();
+	}
+
+	auto remove_(PlaceValue const& p) noexcept -> void
+	{
+		using Card = Proto::Duel::Msg::Event::Card;
+		model_.card_remove(p);
+		to_proto(p, *card_(Card::kRemove).mutable_remove()->add_places());
+	}
+
+	auto add_(PlaceValue const& p) noexcept -> void
+	{
+		using Card = Proto::Duel::Msg::Event::Card;
+		model_.card_add(p) = NONE;
+		to_proto(p, *card_(Card::kAdd).mutable_add()->add_places());
+	}
+
+	auto move_(PlaceValue const& from, PlaceValue const& to) noexcept -> void
+	{
+		using Card = Proto::Duel::Msg::Event::Card;
+		model_.card_move(from, to);
+		auto& op = *card_(Card::kMove).mutable_move()->add_ops();
+		to_proto(from, *op.mutable_old_place());
+		to_proto(to, *op.mutable_new_place());
+	}
+
+	auto swap_(PlaceValue const& a, PlaceValue const& b) noexcept -> void
+	{
+		using Card = Proto::Duel::Msg::Event::Card;
+		model_.card_swap(a, b);
+		auto& op = *card_(Card::kExchange).mutable_exchange()->add_ops();
+		to_proto(a, *op.mutable_place_a());
+		to_proto(b, *op.mutable_place_b());
+	}
+
+	auto splice_(PlaceValue const& from, size_t count,
+	             PlaceValue const& to) noexcept -> void
+	{
+		using Pile = Proto::Duel::Msg::Event::Pile;
+		model_.pile_splice(from, count, to, false);
+		auto* e = last_event_();
+		if(e == nullptr || !e->has_pile() ||
+		   e->pile().t_case() != Pile::kSplice)
+			e = &event_();
+		auto& op = *e->mutable_pile()->mutable_splice()->add_ops();
+		to_proto(from, *op.mutable_from());
+		op.set_count(static_cast<uint32_t>(count));
+		to_proto(to, *op.mutable_to());
+	}
+
+	auto resize_(PlaceValue const& p, size_t count) noexcept -> void
+	{
+		using Board = Proto::Duel::Msg::Event::Board;
+		auto const& pile = model_.pile(p);
+		auto const first = pile.size();
+		model_.pile_resize(p, count);
+		for(size_t i = first; i < count; i++)
+			*pile[i] = NONE;
+		auto* e = last_event_();
+		// NOTE: Exchanges have a single controller, so ones for the other
+		// controller get an event of their own.
+		if(e == nullptr || !e->has_board() ||
+		   e->board().t_case() != Board::kExchange ||
+		   e->board().exchange().con() != p.con())
+			e = &event_();
+		auto& exchange = *e->mutable_board()->mutable_exchange();
+		exchange.set_con(p.con());
+		auto& op = *exchange.mutable_resize()->add_ops();
+		to_proto(p, *op.mutable_place());
+		op.set_count(static_cast<uint32_t>(count));
+	}
+};
+
+} // namespace Detail
+
+// Messages that, parsed in order (their events with `parse_event` and then
+// their queries with `parse_query`), turn board `from` into board `to`, for
+// catching up a client that already has `from` without sending it the whole
+// `to` board again.
+//
+// Cards are told apart only by their values: cards that are already where
+// they should be are left alone, cards with the same values as one
+// elsewhere are moved there (runs of them in the same order between piles
+// are spliced at once) and only the remaining cards are removed, added, or
+// have their values changed. This is not guaranteed to be the shortest
+// sequence possible, but usually is close to it.
+//
+// NOTE: Turns only go forward, so `to` must not be at an earlier turn than
+// `from`.
+template<typename BoardFrom, typename BoardTo>
+[[nodiscard]] auto diff(BoardFrom const& from, BoardTo const& to) noexcept
+	-> google::protobuf::RepeatedPtrField<Proto::Duel::Msg>
+{
+	using namespace YGOpen::Duel;
+	using namespace YGOpen::Proto::Duel;
+	using Detail::hash_value;
+	using Detail::value_of;
+	google::protobuf::RepeatedPtrField<Msg> msgs;
+	google::protobuf::RepeatedPtrField<Msg::Query> queries;
+	Detail::FrameDiff(from.frame(), to.frame(), msgs).run(queries);
+	auto const& chains_from = value_of(from.chain_stack());
+	auto const& chains_to = value_of(to.chain_stack());
+	size_t common = 0U;
+	while(common < chains_from.size() && common < chains_to.size() &&
+	      hash_value(chains_from[common]) == hash_value(chains_to[common]))
+		common++;
+	for(size_t i = chains_from.size(); i != common; i--)
+		msgs.Add()->mutable_event()->mutable_chain_stack()->set_pop(true);
+	for(size_t i = common; i < chains_to.size(); i++)
+	{
+		auto& push = *msgs.Add()->mutable_event()->mutable_chain_stack();
+		to_proto(chains_to[i], *push.mutable_push());
+	}
+	auto const turn_to = uint32_t{to.turn()};
+	assert(uint32_t{from.turn()} <= turn_to);
+	for(auto turn = uint32_t{from.turn()}; turn < turn_to; turn++)
+	{
+		auto const con = Controller{to.turn_controller()};
+		msgs.Add()->mutable_event()->set_next_turn(con);
+	}
+	if(Phase{from.phase()} != Phase{to.phase()})
+		msgs.Add()->mutable_event()->set_next_phase(Phase{to.phase()});
+	for(auto con : {CONTROLLER_0, CONTROLLER_1})
+	{
+		auto const lp = uint32_t{to.lp(con)};
+		if(uint32_t{from.lp(con)} == lp)
+			continue;
+		auto& e = *msgs.Add()->mutable_event()->mutable_lp();
+		e.set_controller(con);
+		e.set_become(lp);
+	}
+	if(hash_value(from.blocked_zones()) != hash_value(to.blocked_zones()))
+	{
+		auto& zones = *msgs.Add()->mutable_event()->mutable_zone_block();
+		for(auto const& zone : value_of(to.blocked_zones()))
+			to_proto(zone, *zones.add_zones());
+	}
+	if(!queries.empty())
+		msgs.Add()->mutable_queries()->Swap(&queries);
+	return msgs;
+}
+
+} // namespace YGOpen::Client
+
+#endif // YGOPEN_CLIENT_BOARD_DIFF_HPP
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_CLIENT_CARD_STORAGE_HPP
+#define YGOPEN_CLIENT_CARD_STORAGE_HPP
+#include <cassert>
+#include <forward_list>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Policies used by BasicFrame to own its cards. Cards must have stable
+// addresses, as piles and zones point to them. Interface:
+//  construct(Card&&) -> Card&: Store a new card.
+//  destruct(Card&) -> void: Destroy a card previously stored.
+
+namespace YGOpen::Client
+{
+
+// Each card is a separate node of a list. Destructing a card is linear on the
+// amount of cards stored.
+template<typename Card>
+class ListCardStorage
+{
+public:
+	auto construct(Card&& card) noexcept -> Card&
+	{
+		return m_.emplace_front(std::move(card));
+	}
+
+	auto destruct(Card& card) noexcept -> void
+	{
+		// NOTE: std::forward_list::remove attempts to remove all elements that
+		// match, but we know that they are unique so no need to traverse the
+		// entire container after the first removal is performed.
+		bool destructed = false;
+		auto const end = m_.cend();
+		auto prev_it = m_.before_begin();
+		using Iter = typename decltype(m_)::iterator;
+		for(Iter it; (it = std::next(prev_it)) != end; prev_it++)
+		{
+			if(&*it != &card)
+				continue;
+			m_.erase_after(prev_it);
+			destructed = true;
+			break;
+		}
+		assert(destructed);
+	}
+
+private:
+	std::forward_list<Card> m_;
+};
+
+// Cards are stored in chunks of `ChunkSize` slots, and slots of destructed
+// cards are reused through an intrusive free list. Constructing and
+// destructing a card are O(1).
+template<typename Card, size_t ChunkSize = 64U>
+class SlabCardStorage
+{
+	static_assert(ChunkSize > 0U);
+
+public:
+	explicit SlabCardStorage() noexcept = default;
+	SlabCardStorage(SlabCardStorage const&) = delete;
+	auto operator=(SlabCardStorage const&) -> SlabCardStorage& = delete;
+
+	SlabCardStorage(SlabCardStorage&& other) noexcept
+		: chunks_(std::move(other.chunks_))
+		, free_(std::exchange(other.free_, nullptr))
+		, used_(std::exchange(other.used_, ChunkSize))
+	{}
+
+	auto operator=(SlabCardStorage&& other) noexcept -> SlabCardStorage&
+	{
+		if(this == &other)
+			return *this;
+		destruct_all_();
+		chunks_ = std::move(other.chunks_);
+		free_ = std::exchange(other.free_, nullptr);
+		used_ = std::exchange(other.used_, ChunkSize);
+		return *this;
+	}
+
+	~SlabCardStorage() noexcept { destruct_all_(); }
+
+	auto construct(Card&& card) noexcept -> Card&
+	{
+		Slot* slot = free_;
+		if(slot != nullptr)
+		{
+			free_ = slot->next;
+		}
+		else
+		{
+			if(used_ == ChunkSize)
+			{
+				chunks_.emplace_back(std::make_unique<Slot[]>(ChunkSize));
+				used_ = 0U;
+			}
+			slot = &chunks_.back()[used_++];
+		}
+		slot->alive = true;
+		return *::new(static_cast<void*>(&slot->storage)) Card(std::move(card));
+	}
+
+	auto destruct(Card& card) noexcept -> void
+	{
+		// NOTE: `storage` is the first member of `Slot`.
+		auto* slot = reinterpret_cast<Slot*>(&card);
+		assert(slot->alive);
+		card.~Card();
+		slot->alive = false;
+		slot->next = free_;
+		free_ = slot;
+	}
+
+private:
+	struct Slot
+	{
+		alignas(Card) unsigned char storage[sizeof(Card)];
+		Slot* next;
+		bool alive;
+	};
+
+	std::vector<std::unique_ptr<Slot[]>> chunks_;
+	Slot* free_{};
+	size_t used_{ChunkSize};
+
+	auto destruct_all_() noexcept -> void
+	{
+		for(auto& chunk : chunks_)
+		{
+			for(size_t i = 0U; i < ChunkSize; i++)
+			{
+				if(chunk[i].alive)
+					std::launder(reinterpret_cast<Card*>(&chunk[i].storage))
+						->~Card();
+			}
+		}
+		chunks_.clear();
+		free_ = nullptr;
+		used_ = ChunkSize;
+	}
+};
+
+} // namespace YGOpen::Client
+
+#endif // YGOPEN_CLIENT_CARD_STORAGE_HPP
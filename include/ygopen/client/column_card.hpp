@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_CLIENT_COLUMN_CARD_HPP
+#define YGOPEN_CLIENT_COLUMN_CARD_HPP
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <ygopen/client/card.hpp>
+#include <ygopen/client/card_storage.hpp>
+#include <ygopen/client/frame.hpp>
+#include <ygopen/detail/config.hpp>
+
+// Struct-of-arrays alternative to BasicCard. The values of every card of a
+// frame are stored in CardColumns, one contiguous column per query, indexed by
+// a card handle. Cards given by the frame are proxies with the same getters as
+// BasicCard, so `parse_query` and friends work unchanged, while code scanning
+// the whole board can walk the columns directly.
+
+namespace YGOpen::Client
+{
+
+template<YGOPEN_CONCEPT(CardTraits)>
+class CardColumns
+{
+public:
+	// Handles are stable for the lifetime of the card they were given to, and
+	// are reused after that.
+	using HandleType = uint32_t;
+
+#define X(NAME, Name, name, value)                                        \
+	using Name##Type = typename CardTraits::Name##Type;                   \
+	[[nodiscard]] auto name(HandleType h) const noexcept                  \
+		-> Name##Type const&                                              \
+	{                                                                     \
+		assert(is_alive(h));                                              \
+		return name##_[h];                                                \
+	}                                                                     \
+	[[nodiscard]] auto name(HandleType h) noexcept -> Name##Type&         \
+	{                                                                     \
+		assert(is_alive(h));                                              \
+		return name##_[h];                                                \
+	}                                                                     \
+	/* Values of all `size()` handles, dead ones included. */             \
+	[[nodiscard]] auto name##_column() const noexcept                     \
+		-> Name##Type const*                                              \
+	{                                                                     \
+		return name##_.get();                                             \
+	}
+#define EXPAND_ARRAY_LIKE_QUERIES
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef EXPAND_ARRAY_LIKE_QUERIES
+#undef X
+
+	explicit CardColumns() noexcept = default;
+	CardColumns(CardColumns const&) = delete;
+	auto operator=(CardColumns const&) -> CardColumns& = delete;
+
+	// Amount of handles ever given, every valid handle is less than this.
+	[[nodiscard]] auto size() const noexcept -> size_t { return size_; }
+
+	[[nodiscard]] auto is_alive(HandleType h) const noexcept -> bool
+	{
+		return h < size_ && alive_[h];
+	}
+
+	// Gets a handle whose values are all default-initialized.
+	[[nodiscard]] auto acquire() noexcept -> HandleType
+	{
+		HandleType h{};
+		if(!free_.empty())
+		{
+			h = free_.back();
+			free_.pop_back();
+		}
+		else
+		{
+			if(size_ == capacity_)
+				grow_();
+			h = static_cast<HandleType>(size_++);
+		}
+#define X(NAME, Name, name, value) name##_[h] = Name##Type{};
+#define EXPAND_ARRAY_LIKE_QUERIES
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef EXPAND_ARRAY_LIKE_QUERIES
+#undef X
+		alive_[h] = true;
+		return h;
+	}
+
+	auto release(HandleType h) noexcept -> void
+	{
+		assert(is_alive(h));
+		alive_[h] = false;
+		free_.push_back(h);
+	}
+
+private:
+	size_t size_{};
+	size_t capacity_{};
+	std::unique_ptr<bool[]> alive_;
+	std::vector<HandleType> free_;
+#define X(NAME, Name, name, value) std::unique_ptr<Name##Type[]> name##_;
+#define EXPAND_ARRAY_LIKE_QUERIES
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef EXPAND_ARRAY_LIKE_QUERIES
+#undef X
+
+	auto grow_() noexcept -> void
+	{
+		auto const capacity = std::max<size_t>(capacity_ * 2U, 64U);
+		grow_column_(alive_, capacity);
+#define X(NAME, Name, name, value) grow_column_(name##_, capacity);
+#define EXPAND_ARRAY_LIKE_QUERIES
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef EXPAND_ARRAY_LIKE_QUERIES
+#undef X
+		capacity_ = capacity;
+	}
+
+	template<typename T>
+	auto grow_column_(std::unique_ptr<T[]>& column, size_t capacity) noexcept
+		-> void
+	{
+		auto grown = std::make_unique<T[]>(capacity);
+		std::move(column.get(), column.get() + size_, grown.get());
+		column = std::move(grown);
+	}
+};
+
+// Card proxy that owns a handle of CardColumns for as long as it lives.
+template<YGOPEN_CONCEPT(CardTraits)>
+class ColumnCard
+{
+public:
+	using ColumnsType = CardColumns<CardTraits>;
+	using HandleType = typename ColumnsType::HandleType;
+
+#define X(NAME, Name, name, value)                                \
+	using Name##Type = typename CardTraits::Name##Type;           \
+	[[nodiscard]] auto name() const noexcept -> Name##Type const& \
+	{                                                             \
+		return columns_->name(handle_);                           \
+	}                                                             \
+	[[nodiscard]] auto name() noexcept -> Name##Type&             \
+	{                                                             \
+		return columns_->name(handle_);                           \
+	}
+#define EXPAND_ARRAY_LIKE_QUERIES
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef EXPAND_ARRAY_LIKE_QUERIES
+#undef X
+
+	explicit ColumnCard(ColumnsType& columns) noexcept
+		: columns_(&columns), handle_(columns.acquire())
+	{}
+
+	~ColumnCard() noexcept
+	{
+		if(columns_ != nullptr)
+			columns_->release(handle_);
+	}
+
+	ColumnCard(ColumnCard const&) = delete;
+	auto operator=(ColumnCard const&) -> ColumnCard& = delete;
+
+	ColumnCard(ColumnCard&& other) noexcept
+		: columns_(std::exchange(other.columns_, nullptr))
+		, handle_(other.handle_)
+	{}
+
+	auto operator=(ColumnCard&& other) noexcept -> ColumnCard&
+	{
+		if(this == &other)
+			return *this;
+		if(columns_ != nullptr)
+			columns_->release(handle_);
+		columns_ = std::exchange(other.columns_, nullptr);
+		handle_ = other.handle_;
+		return *this;
+	}
+
+	[[nodiscard]] auto handle() const noexcept -> HandleType { return handle_; }
+
+private:
+	ColumnsType* columns_;
+	HandleType handle_;
+};
+
+// Card builder for BasicFrame that owns the columns its cards live in.
+template<YGOPEN_CONCEPT(CardTraits)>
+class ColumnCardBuilder
+{
+public:
+	using ColumnsType = CardColumns<CardTraits>;
+
+	explicit ColumnCardBuilder() noexcept
+		: columns_(std::make_unique<ColumnsType>())
+	{}
+
+	// NOTE: Copies get their own, empty, columns, so only builders without
+	// cards may be copied. BasicFrame copies the builder it is constructed
+	// with, and frames using this builder cannot be copied.
+	ColumnCardBuilder(ColumnCardBuilder const& other) noexcept
+		: ColumnCardBuilder()
+	{
+		assert(other.columns_ == nullptr || other.columns_->size() == 0U);
+		static_cast<void>(other);
+	}
+
+	// Cards keep pointing to the columns, which are taken as a whole.
+	ColumnCardBuilder(ColumnCardBuilder&& other) noexcept = default;
+
+	auto operator=(ColumnCardBuilder const&) -> ColumnCardBuilder& = delete;
+
+	[[nodiscard]] auto build() noexcept -> ColumnCard<CardTraits>
+	{
+		return ColumnCard<CardTraits>(*columns_);
+	}
+
+	[[nodiscard]] auto columns() const noexcept -> ColumnsType const&
+	{
+		return *columns_;
+	}
+
+	[[nodiscard]] auto columns() noexcept -> ColumnsType& { return *columns_; }
+
+private:
+	// NOTE: Behind a pointer so cards can refer to it even if moved.
+	std::unique_ptr<ColumnsType> columns_;
+};
+
+template<YGOPEN_CONCEPT(CardTraits)>
+using ColumnFrame =
+	BasicFrame<ColumnCard<CardTraits>, ColumnCardBuilder<CardTraits>,
+	           SlabCardStorage<ColumnCard<CardTraits>>>;
+
+} // namespace YGOpen::Client
+
+#endif // YGOPEN_CLIENT_COLUMN_CARD_HPP
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_CLIENT_EVENT_SEEKER_HPP
+#define YGOPEN_CLIENT_EVENT_SEEKER_HPP
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+#include <ygopen/client/parse_event.hpp>
+#include <ygopen/client/undo_parse_event.hpp>
+#include <ygopen/duel/constants/controller.hpp>
+#include <ygopen/proto/duel/msg.hpp>
+
+namespace YGOpen::Client
+{
+
+// Random access over the events parsed by an undoable board. Every so often
+// a checkpoint of the board is kept, so moving to any event only restores the
+// checkpoint nearest to it and parses or undoes the few events in between,
+// instead of every event since the board's current one.
+//
+// Requirements: The board's frame is a LimboFrame and every other value of
+// the board is a BasicUndoable (or has the same `position` and `seek`).
+//
+// NOTE: Only events whose operations and values are still in the history of
+// the board can be seeked to, so it must not be limited nor erased. Stale
+// checkpoints (see `LimboFrame::can_restore`) are never restored.
+template<YGOPEN_CONCEPT(UndoableBoard)>
+class BasicEventSeeker
+{
+public:
+	using BoardType = UndoableBoard;
+	using FrameType = typename BoardType::FrameType;
+
+	// Checkpoints are kept at least every this many frame operations, or
+	// events if those do not operate on the frame.
+	static constexpr size_t DEFAULT_INTERVAL = 256U;
+
+	explicit BasicEventSeeker(BoardType& board,
+	                          size_t interval = DEFAULT_INTERVAL) noexcept
+		: board_(&board), interval_(interval), event_(0U), parsed_(0U)
+	{
+		assert(interval_ > 0U);
+		checkpoints_.push_back(checkpoint_());
+	}
+
+	// Index of the next event, every event below it is applied to the board.
+	[[nodiscard]] auto position() const noexcept -> size_t { return event_; }
+
+	// Amount of events parsed so far.
+	[[nodiscard]] auto size() const noexcept -> size_t { return parsed_; }
+
+	// Parses the event that follows all the ones parsed so far, the board
+	// must be at the last one.
+	auto parse(Proto::Duel::Msg::Event const& event) noexcept -> void
+	{
+		assert(event_ == parsed_);
+		parse_event(*board_, event);
+		event_ = ++parsed_;
+		auto const& last = checkpoints_.back();
+		if(board_->frame().operation() - last.frame.operation() >= interval_ ||
+		   event_ - last.event >= interval_)
+			checkpoints_.push_back(checkpoint_());
+	}
+
+	// Moves the board to how it was right before the event at `index`.
+	// `events` are the ones given to `parse`, in the same order.
+	template<typename Events>
+	auto seek_to(Events const& events, size_t index) noexcept -> void
+	{
+		assert(index <= parsed_ && parsed_ <= events.size());
+		auto after = std::upper_bound(
+			checkpoints_.cbegin(), checkpoints_.cend(), index,
+			[](size_t i, Checkpoint const& cp) { return i < cp.event; });
+		auto before = after - 1;
+		// Restore the checkpoint that leaves the least events to go through,
+		// if any of them is nearer than where the board already is.
+		auto distance = [index](size_t event)
+		{
+			return (event < index) ? index - event : event - index;
+		};
+		auto const& frame = board_->frame();
+		auto const* nearest = &*before;
+		if(after != checkpoints_.cend() && frame.can_restore(after->frame) &&
+		   (distance(after->event) < distance(before->event) ||
+		    !frame.can_restore(before->frame)))
+			nearest = &*after;
+		if(distance(nearest->event) < distance(event_) &&
+		   frame.can_restore(nearest->frame))
+			restore_(*nearest);
+		for(; event_ < index; event_++)
+			parse_event(*board_, events[event_]);
+		for(; event_ > index; event_--)
+			undo_parse_event(*board_, events[event_ - 1U]);
+	}
+
+private:
+	template<typename T>
+	using PositionOf = typename T::PositionType;
+
+	struct Checkpoint
+	{
+		size_t event;
+		typename FrameType::Checkpoint frame;
+		PositionOf<typename BoardType::ChainStackType> chain_stack;
+		PositionOf<typename BoardType::TurnType> turn;
+		PositionOf<typename BoardType::TurnControllerType> turn_controller;
+		std::array<PositionOf<typename BoardType::LPType>, 2U> lp;
+		PositionOf<typename BoardType::PhaseType> phase;
+		PositionOf<typename BoardType::BlockedZonesType> blocked_zones;
+	};
+
+	BoardType* board_;
+	size_t interval_;
+	size_t event_;
+	size_t parsed_;
+	std::vector<Checkpoint> checkpoints_;
+
+	auto checkpoint_() const noexcept -> Checkpoint
+	{
+		using namespace YGOpen::Duel;
+		auto const& b = *board_;
+		return {event_,
+		        b.frame().checkpoint(),
+		        b.chain_stack().position(),
+		        b.turn().position(),
+		        b.turn_controller().position(),
+		        {b.lp(CONTROLLER_0).position(), b.lp(CONTROLLER_1).position()},
+		        b.phase().position(),
+		        b.blocked_zones().position()};
+	}
+
+	auto restore_(Checkpoint const& cp) noexcept -> void
+	{
+		using namespace YGOpen::Duel;
+		auto& b = *board_;
+		[[maybe_unused]] bool const restored = b.frame().restore(cp.frame);
+		assert(restored);
+		b.chain_stack().seek(cp.chain_stack);
+		b.turn().seek(cp.turn);
+		b.turn_controller().seek(cp.turn_controller);
+		b.lp(CONTROLLER_0).seek(cp.lp[0U]);
+		b.lp(CONTROLLER_1).seek(cp.lp[1U]);
+		b.phase().seek(cp.phase);
+		b.blocked_zones().seek(cp.blocked_zones);
+		event_ = cp.event;
+	}
+};
+
+} // namespace YGOpen::Client
+
+#endif // YGOPEN_CLIENT_EVENT_SEEKER_HPP
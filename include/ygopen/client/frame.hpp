@@ -8,8 +8,12 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
-#include <forward_list>
+#include <cstdint>
 #include <vector>
+#include <ygopen/client/card_storage.hpp>
+#include <ygopen/client/pile_storage.hpp>
+#include <ygopen/client/value_types.hpp>
+#include <ygopen/bit.hpp>
 #include <ygopen/detail/config.hpp>
 #include <ygopen/duel/constants/controller.hpp>
 #include <ygopen/duel/constants/location.hpp>
@@ -41,31 +45,105 @@ enum FieldZoneLimit : size_t
 	FIELD_ZONE_LIMIT_SKILL = 1U,
 };
 
+// Pile and zone locations, each in the order of their dense index.
+constexpr std::array PILE_LOCATIONS{
+	YGOpen::Duel::LOCATION_MAIN_DECK, YGOpen::Duel::LOCATION_HAND,
+	YGOpen::Duel::LOCATION_GRAVEYARD, YGOpen::Duel::LOCATION_BANISHED,
+	YGOpen::Duel::LOCATION_EXTRA_DECK};
+constexpr std::array ZONE_LOCATIONS{
+	YGOpen::Duel::LOCATION_MONSTER_ZONE, YGOpen::Duel::LOCATION_SPELL_ZONE,
+	YGOpen::Duel::LOCATION_FIELD_ZONE, YGOpen::Duel::LOCATION_PENDULUM_ZONE,
+	YGOpen::Duel::LOCATION_SKILL_ZONE};
+constexpr std::array<size_t, ZONE_LOCATIONS.size()> ZONE_LIMITS{
+	FIELD_ZONE_LIMIT_MONSTER, FIELD_ZONE_LIMIT_SPELL, FIELD_ZONE_LIMIT_FIELD,
+	FIELD_ZONE_LIMIT_PENDULUM, FIELD_ZONE_LIMIT_SKILL};
+
+// Tables indexed by the position of a location's bit.
+constexpr size_t LOCATION_BITS =
+	Bit::ctz(uint32_t{YGOpen::Duel::LOCATION_SKILL_ZONE}) + 1U;
+
+struct LocationInfo
+{
+	uint8_t index; // Dense index among piles or among zones.
+	uint8_t seq_lim; // Zone sequence limit, 0 for piles.
+	uint8_t offset; // Offset of the first zone of the location.
+};
+
+constexpr auto make_location_table() noexcept
+	-> std::array<LocationInfo, LOCATION_BITS>
+{
+	std::array<LocationInfo, LOCATION_BITS> table{};
+	for(size_t i = 0U; i < PILE_LOCATIONS.size(); i++)
+		table[Bit::ctz(uint32_t{PILE_LOCATIONS[i]})].index =
+			static_cast<uint8_t>(i);
+	size_t offset = 0U;
+	for(size_t i = 0U; i < ZONE_LOCATIONS.size(); i++)
+	{
+		auto& info = table[Bit::ctz(uint32_t{ZONE_LOCATIONS[i]})];
+		info.index = static_cast<uint8_t>(i);
+		info.seq_lim = static_cast<uint8_t>(ZONE_LIMITS[i]);
+		info.offset = static_cast<uint8_t>(offset);
+		offset += ZONE_LIMITS[i];
+	}
+	return table;
+}
+
+constexpr auto LOCATION_TABLE = make_location_table();
+
+// Amount of zones a single controller has.
+constexpr size_t ZONE_COUNT = []()
+{
+	size_t count = 0U;
+	for(auto lim : ZONE_LIMITS)
+		count += lim;
+	return count;
+}();
+
+[[nodiscard]] constexpr auto location_info(YGOpen::Duel::Location loc) noexcept
+	-> LocationInfo const&
+{
+	// NOTE: Only a single location can be looked up.
+	assert(Bit::popcnt(uint32_t{loc}) == 1U);
+	assert(Bit::ctz(uint32_t{loc}) < LOCATION_BITS);
+	return LOCATION_TABLE[Bit::ctz(uint32_t{loc})];
+}
+
 } // namespace Detail
 
+// Dense index of `loc` among the pile locations if it is a pile, or among the
+// zone locations if it is a zone.
+[[nodiscard]] constexpr auto loc_index(YGOpen::Duel::Location loc) noexcept
+	-> size_t
+{
+	return Detail::location_info(loc).index;
+}
+
 [[nodiscard]] constexpr auto zone_seq_lim(YGOpen::Duel::Location loc) noexcept
 	-> size_t
 {
-	using namespace YGOpen::Duel;
-	if(loc == LOCATION_MONSTER_ZONE)
-		return Detail::FIELD_ZONE_LIMIT_MONSTER;
-	if(loc == LOCATION_SPELL_ZONE)
-		return Detail::FIELD_ZONE_LIMIT_SPELL;
-	if(loc == LOCATION_FIELD_ZONE)
-		return Detail::FIELD_ZONE_LIMIT_FIELD;
-	if(loc == LOCATION_PENDULUM_ZONE)
-		return Detail::FIELD_ZONE_LIMIT_PENDULUM;
-	if(loc == LOCATION_SKILL_ZONE)
-		return Detail::FIELD_ZONE_LIMIT_SKILL;
-	YGOPEN_UNREACHABLE();
+	assert(is_zone(loc));
+	return Detail::location_info(loc).seq_lim;
 }
 
-template<typename Card, typename CardBuilder = Detail::DefaultBuilder<Card>>
+// Index of the zone at `seq` of `loc` among all zones of a controller.
+[[nodiscard]] constexpr auto zone_index(YGOpen::Duel::Location loc,
+                                        uint32_t seq) noexcept -> size_t
+{
+	assert(seq < zone_seq_lim(loc));
+	return Detail::location_info(loc).offset + seq;
+}
+
+template<typename Card, typename CardBuilder = Detail::DefaultBuilder<Card>,
+         typename CardStorage = ListCardStorage<Card>,
+         typename PileStorage = VectorPileStorage<Card>>
 class BasicFrame
 {
 public:
 	using CardType = Card;
-	using PileType = std::vector<CardType*>;
+	using PileType = typename PileStorage::PileType;
+	using MaterialsType = typename PileStorage::MaterialsType;
+	// NOTE: Functions taking places are templates, so PlaceValue (see
+	// value_types.hpp) can be given too. Both types have the same getters.
 	using PlaceType = Proto::Duel::Place;
 
 	class Side
@@ -74,7 +152,7 @@ public:
 		struct Zone
 		{
 			CardType* card{};
-			PileType materials;
+			MaterialsType materials;
 		};
 
 		[[nodiscard]] constexpr auto operator[](
@@ -92,32 +170,14 @@ public:
 	private:
 		friend BasicFrame;
 
-		template<size_t Size>
-		using ZoneArray = std::array<Zone, Size>;
-
-		ZoneArray<zone_seq_lim(YGOpen::Duel::LOCATION_MONSTER_ZONE)> monster_;
-		ZoneArray<zone_seq_lim(YGOpen::Duel::LOCATION_SPELL_ZONE)> spell_;
-		ZoneArray<zone_seq_lim(YGOpen::Duel::LOCATION_FIELD_ZONE)> field_;
-		ZoneArray<zone_seq_lim(YGOpen::Duel::LOCATION_PENDULUM_ZONE)> pendulum_;
-		ZoneArray<zone_seq_lim(YGOpen::Duel::LOCATION_SKILL_ZONE)> skill_;
+		std::array<Zone, Detail::ZONE_COUNT> zones_;
 
 		// FIXME: Use std::span as return type if we ever move to >=C++20.
 		template<typename T>
 		static constexpr auto at_(T& t, Duel::Location loc) noexcept -> auto*
 		{
 			assert(is_zone(loc));
-			using namespace YGOpen::Duel;
-			if(loc == LOCATION_MONSTER_ZONE)
-				return t.monster_.data();
-			if(loc == LOCATION_SPELL_ZONE)
-				return t.spell_.data();
-			if(loc == LOCATION_FIELD_ZONE)
-				return t.field_.data();
-			if(loc == LOCATION_PENDULUM_ZONE)
-				return t.pendulum_.data();
-			if(loc == LOCATION_SKILL_ZONE)
-				return t.skill_.data();
-			YGOPEN_UNREACHABLE();
+			return t.zones_.data() + zone_index(loc, 0U);
 		}
 	};
 
@@ -135,7 +195,8 @@ public:
 		return cards_;
 	}
 
-	[[nodiscard]] constexpr auto has_card(PlaceType const& place) const noexcept
+	template<typename Place>
+	[[nodiscard]] constexpr auto has_card(Place const& place) const noexcept
 		-> bool
 	{
 		assert(!is_empty(place));
@@ -149,7 +210,8 @@ public:
 		return static_cast<size_t>(place.oseq()) < z.materials.size();
 	}
 
-	[[nodiscard]] constexpr auto card(PlaceType const& place) const noexcept
+	template<typename Place>
+	[[nodiscard]] constexpr auto card(Place const& place) const noexcept
 		-> CardType const&
 	{
 		return card_(*this, place);
@@ -162,7 +224,8 @@ public:
 		return pile_(*this, con, loc);
 	}
 
-	[[nodiscard]] constexpr auto pile(PlaceType const& place) const noexcept
+	template<typename Place>
+	[[nodiscard]] constexpr auto pile(Place const& place) const noexcept
 		-> PileType const&
 	{
 		return pile_(*this, get_con(place), get_loc(place));
@@ -175,7 +238,8 @@ public:
 		return zone_(*this, con, loc, seq);
 	}
 
-	[[nodiscard]] constexpr auto zone(PlaceType const& place) const noexcept ->
+	template<typename Place>
+	[[nodiscard]] constexpr auto zone(Place const& place) const noexcept ->
 		typename Side::Zone const&
 	{
 		return zone(get_con(place), get_loc(place), place.seq());
@@ -188,7 +252,8 @@ public:
 		return cards_;
 	}
 
-	[[nodiscard]] constexpr auto card(PlaceType const& place) noexcept
+	template<typename Place>
+	[[nodiscard]] constexpr auto card(Place const& place) noexcept
 		-> CardType&
 	{
 		return card_(*this, place);
@@ -200,7 +265,8 @@ public:
 		return pile_(*this, con, loc);
 	}
 
-	[[nodiscard]] constexpr auto pile(PlaceType const& place) noexcept
+	template<typename Place>
+	[[nodiscard]] constexpr auto pile(Place const& place) noexcept
 		-> PileType&
 	{
 		return pile_(*this, get_con(place), get_loc(place));
@@ -213,7 +279,8 @@ public:
 		return zone_(*this, con, loc, seq);
 	}
 
-	[[nodiscard]] constexpr auto zone(PlaceType const& place) noexcept ->
+	template<typename Place>
+	[[nodiscard]] constexpr auto zone(Place const& place) noexcept ->
 		typename Side::Zone&
 	{
 		return zone(get_con(place), get_loc(place), place.seq());
@@ -221,21 +288,34 @@ public:
 
 	// Modifiers.
 
-	constexpr auto card_add(PlaceType const& place) noexcept -> CardType&
+	template<typename Place>
+	constexpr auto card_add(Place const& place) noexcept -> CardType&
 	{
 		CardType& c = construct_card();
 		card_insert(place, c);
 		return c;
 	}
 
-	constexpr auto card_remove(PlaceType const& place) noexcept -> void
+	// Same as calling `card_add` with every place of [first, last) in order,
+	// but piles grow at most once.
+	template<typename ForwardIt>
+	constexpr auto cards_add(ForwardIt first, ForwardIt last) noexcept -> void
+	{
+		pile_reserve(first, last);
+		for(; first != last; ++first)
+			card_add(*first);
+	}
+
+	template<typename Place>
+	constexpr auto card_remove(Place const& place) noexcept -> void
 	{
 		assert(has_card(place));
 		destruct_card(card_erase(place));
 	}
 
-	constexpr auto card_move(PlaceType const& from,
-	                         PlaceType const& to) noexcept -> CardType&
+	template<typename Place>
+	constexpr auto card_move(Place const& from,
+	                         Place const& to) noexcept -> CardType&
 	{
 		assert(has_card(from));
 		bool const is_from_pile = is_pile(from);
@@ -341,7 +421,8 @@ public:
 		}
 	}
 
-	constexpr auto card_swap(PlaceType const& a, PlaceType const& b) noexcept
+	template<typename Place>
+	constexpr auto card_swap(Place const& a, Place const& b) noexcept
 		-> void
 	{
 		assert(has_card(a));
@@ -397,16 +478,17 @@ public:
 			}
 			else if(!is_a_not_mat && is_b_not_mat)
 			{
-				std::swap(za.materials[a.seq()], zb.card);
+				std::swap(za.materials[a.oseq()], zb.card);
 			}
 			else // !is_a_not_mat && !is_b_not_mat
 			{
-				std::swap(za.materials[a.seq()], zb.materials[b.oseq()]);
+				std::swap(za.materials[a.oseq()], zb.materials[b.oseq()]);
 			}
 		}
 	}
 
-	constexpr auto pile_resize(PlaceType const& place, size_t count) noexcept
+	template<typename Place>
+	constexpr auto pile_resize(Place const& place, size_t count) noexcept
 		-> void
 	{
 		assert(is_pile(place));
@@ -427,8 +509,9 @@ public:
 		verify_pile_(p);
 	}
 
-	constexpr auto pile_splice(PlaceType const& from, size_t count,
-	                           PlaceType const& to, bool reverse) noexcept
+	template<typename Place>
+	constexpr auto pile_splice(Place const& from, size_t count,
+	                           Place const& to, bool reverse) noexcept
 		-> void
 	{
 		assert(is_pile(from));
@@ -456,7 +539,8 @@ public:
 		}
 	}
 
-	constexpr auto pile_swap(PlaceType const& a, PlaceType const& b) noexcept
+	template<typename Place>
+	constexpr auto pile_swap(Place const& a, Place const& b) noexcept
 		-> void
 	{
 		assert(is_pile(a));
@@ -469,39 +553,26 @@ public:
 	// just recreate the object in place (use std::optional or similar).
 	constexpr auto clear() noexcept -> void
 	{
-		auto destruct_pile = [this](PileType& p)
+		auto destruct_pile = [this](auto& p)
 		{
 			for(auto* c : p)
 				destruct_card(*c);
 			p.clear();
 		};
-		auto destruct_zone_location = [&](auto& loc)
+		for(auto& con_piles : piles_)
 		{
-			for(auto& zone : loc)
+			for(auto& p : con_piles)
+				destruct_pile(p);
+		}
+		for(auto& side : field_)
+		{
+			for(auto& zone : side.zones_)
 			{
 				if(zone.card != nullptr)
 					destruct_card(*zone.card);
 				zone.card = nullptr;
 				destruct_pile(zone.materials);
 			}
-		};
-		for(auto& p : main_deck_)
-			destruct_pile(p);
-		for(auto& p : hand_)
-			destruct_pile(p);
-		for(auto& p : graveyard_)
-			destruct_pile(p);
-		for(auto& p : banished_)
-			destruct_pile(p);
-		for(auto& p : extra_deck_)
-			destruct_pile(p);
-		for(auto& side : field_)
-		{
-			destruct_zone_location(side.monster_);
-			destruct_zone_location(side.spell_);
-			destruct_zone_location(side.field_);
-			destruct_zone_location(side.pendulum_);
-			destruct_zone_location(side.skill_);
 		}
 	}
 
@@ -515,7 +586,8 @@ protected:
 
 	// Methods that compose add and remove operations.
 
-	constexpr auto card_insert(PlaceType const& place, CardType& c) noexcept
+	template<typename Place>
+	constexpr auto card_insert(Place const& place, CardType& c) noexcept
 		-> void
 	{
 		if(is_pile(place))
@@ -533,7 +605,8 @@ protected:
 		insert_at_(z.materials, place.oseq(), &c);
 	}
 
-	constexpr auto card_erase(PlaceType const& place) noexcept -> CardType&
+	template<typename Place>
+	constexpr auto card_erase(Place const& place) noexcept -> CardType&
 	{
 		CardType* c = nullptr;
 		if(is_pile(place))
@@ -553,57 +626,64 @@ protected:
 		return *c;
 	}
 
+	// Makes room in every pile for the cards that adding all the places of
+	// [first, last) puts in it.
+	template<typename ForwardIt>
+	constexpr auto pile_reserve(ForwardIt first, ForwardIt last) noexcept
+		-> void
+	{
+		std::array<std::array<size_t, Detail::PILE_LOCATIONS.size()>,
+		           Duel::CONTROLLER_ARRAY_SIZE>
+			counts{};
+		for(; first != last; ++first)
+		{
+			if(is_pile(*first))
+				counts[get_con(*first)][loc_index(get_loc(*first))]++;
+		}
+		for(size_t con = 0U; con < counts.size(); con++)
+		{
+			for(size_t i = 0U; i < counts[con].size(); i++)
+			{
+				auto& p = piles_[con][i];
+				if(counts[con][i] != 0U)
+					p.reserve(p.size() + counts[con][i]);
+			}
+		}
+	}
+
 	[[nodiscard]] constexpr auto construct_card() noexcept -> CardType&
 	{
-		return cards_.m.emplace_front(cards_.build());
+		return cards_.m.construct(cards_.build());
 	}
 
 	constexpr auto destruct_card(CardType& c) noexcept -> void
 	{
-		// NOTE: std::forward_list::remove attempts to remove all elements that
-		// match, but we know that they are unique so no need to traverse the
-		// entire container after the first removal is performed.
-		bool destructed = false;
-		auto const end = cards_.m.cend();
-		auto prev_it = cards_.m.before_begin();
-		using Iter = typename decltype(cards_.m)::iterator;
-		for(Iter it; (it = std::next(prev_it)) != end; prev_it++)
-		{
-			if(&*it != &c)
-				continue;
-			cards_.m.erase_after(prev_it);
-			destructed = true;
-			break;
-		}
-		assert(destructed);
+		cards_.m.destruct(c);
 	}
 
 	// Debug functions.
 
-	static constexpr auto verify_pile_(PileType const& p) noexcept -> void
+	template<typename Pile>
+	static constexpr auto verify_pile_(Pile const& p) noexcept -> void
 	{
 		for(auto c : p)
 			assert(c != nullptr);
 	}
 
 private:
-	using MultiPile = std::array<PileType, Duel::CONTROLLER_ARRAY_SIZE>;
-
 	// NOTE: Empty base optimization.
 	struct Packed : public CardBuilder
 	{
-		std::forward_list<CardType> m;
+		CardStorage m;
 		explicit constexpr Packed(CardBuilder const& b) noexcept
 			: CardBuilder(b), m()
 		{}
 	};
 	Packed cards_;
 
-	MultiPile main_deck_;
-	MultiPile hand_;
-	MultiPile graveyard_;
-	MultiPile banished_;
-	MultiPile extra_deck_;
+	std::array<std::array<PileType, Detail::PILE_LOCATIONS.size()>,
+	           Duel::CONTROLLER_ARRAY_SIZE>
+		piles_;
 	FieldType field_;
 
 	PileType pile_splice_cache_;
@@ -616,22 +696,11 @@ private:
 	{
 		assert(con <= 1);
 		assert(is_pile(loc));
-		using namespace YGOpen::Duel;
-		if(loc == LOCATION_MAIN_DECK)
-			return t.main_deck_[con];
-		if(loc == LOCATION_HAND)
-			return t.hand_[con];
-		if(loc == LOCATION_GRAVEYARD)
-			return t.graveyard_[con];
-		if(loc == LOCATION_BANISHED)
-			return t.banished_[con];
-		if(loc == LOCATION_EXTRA_DECK)
-			return t.extra_deck_[con];
-		YGOPEN_UNREACHABLE();
+		return t.piles_[con][loc_index(loc)];
 	}
 
-	template<typename T>
-	static constexpr auto card_(T& t, PlaceType const& place) noexcept -> auto&
+	template<typename T, typename Place>
+	static constexpr auto card_(T& t, Place const& place) noexcept -> auto&
 	{
 		assert(!is_empty(place));
 		assert(t.has_card(place));
@@ -649,13 +718,13 @@ private:
 	{
 		assert(con <= 1);
 		assert(seq < zone_seq_lim(loc));
-		return ((t.field_[con])[loc])[seq];
+		return t.field_[con].zones_[zone_index(loc, seq)];
 	}
 
 	// Utility functions.
 
-	static constexpr auto take_at_(PileType& p, size_t index) noexcept
-		-> CardType*
+	template<typename Pile>
+	static constexpr auto take_at_(Pile& p, size_t index) noexcept -> CardType*
 	{
 		assert(p.size() > index);
 		CardType* c = p[index];
@@ -664,7 +733,8 @@ private:
 		return c;
 	}
 
-	static constexpr auto insert_at_(PileType& p, size_t index,
+	template<typename Pile>
+	static constexpr auto insert_at_(Pile& p, size_t index,
 	                                 CardType* c) noexcept -> CardType*
 	{
 		assert(p.size() >= index);
@@ -674,6 +744,52 @@ private:
 	}
 };
 
+namespace Detail
+{
+
+// Calls `f` with the place of every card of `frame` and the card, zone cards
+// first, then materials, then piles.
+template<typename Frame, typename F>
+auto for_each_card(Frame const& frame, F&& f) noexcept -> void
+{
+	using namespace YGOpen::Duel;
+	constexpr auto OSEQ_NONE = Proto::Duel::OSEQ_INVALID;
+	for(auto con : {CONTROLLER_0, CONTROLLER_1})
+	{
+		for(auto loc : ZONE_LOCATIONS)
+		{
+			for(uint32_t seq = 0U; seq < zone_seq_lim(loc); seq++)
+			{
+				if(auto const* c = frame.zone(con, loc, seq).card)
+					f(PlaceValue{con, loc, seq, OSEQ_NONE}, *c);
+			}
+		}
+	}
+	for(auto con : {CONTROLLER_0, CONTROLLER_1})
+	{
+		for(auto loc : ZONE_LOCATIONS)
+		{
+			for(uint32_t seq = 0U; seq < zone_seq_lim(loc); seq++)
+			{
+				int32_t oseq = 0;
+				for(auto const* c : frame.zone(con, loc, seq).materials)
+					f(PlaceValue{con, loc, seq, oseq++}, *c);
+			}
+		}
+	}
+	for(auto con : {CONTROLLER_0, CONTROLLER_1})
+	{
+		for(auto loc : PILE_LOCATIONS)
+		{
+			uint32_t seq = 0U;
+			for(auto const* c : frame.pile(con, loc))
+				f(PlaceValue{con, loc, seq++, OSEQ_NONE}, *c);
+		}
+	}
+}
+
+} // namespace Detail
+
 } // namespace YGOpen::Client
 
 #endif // YGOPEN_CLIENT_FRAME_HPP
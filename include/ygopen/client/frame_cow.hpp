@@ -0,0 +1,637 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_CLIENT_FRAME_COW_HPP
+#define YGOPEN_CLIENT_FRAME_COW_HPP
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <ygopen/client/frame.hpp>
+#include <ygopen/client/parse_query.hpp>
+#include <ygopen/duel/constants/controller.hpp>
+#include <ygopen/duel/constants/location.hpp>
+
+namespace YGOpen::Client
+{
+
+namespace Detail
+{
+
+// Assigns every value of `src` to `dst`. Cards are not copyable on purpose,
+// this is only meant for frames that need to duplicate them (see CowFrame).
+template<typename Card>
+constexpr auto copy_card_values(Card& dst, Card const& src) noexcept -> void
+{
+#define X(NAME, Name, name, value)                                  \
+	{                                                               \
+		using ValueType = ValueTypeOrT<typename Card::Name##Type>; \
+		dst.name() = static_cast<ValueType const&>(src.name());     \
+	}
+#define EXPAND_ARRAY_LIKE_QUERIES
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef EXPAND_ARRAY_LIKE_QUERIES
+#undef X
+}
+
+} // namespace Detail
+
+// Frame whose copies share all of their cards, piles and zones until they are
+// modified, so cloning it is O(1) regardless of how many cards it has. A
+// modification only copies what it touches: the pile or zones changed and,
+// for `card`, the card itself. Meant for trying many what-ifs on the same
+// duel (for instance, a search over the answers to a request), where each
+// branch is a clone given to `parse_event` and `parse_query`.
+//
+// Has the same getters and modifiers as BasicFrame, with piles and zones
+// only given out as const, as they may be shared. BasicBoard can be given
+// this frame too, and copying such a board is just as cheap.
+//
+// NOTE: The non-const `card` copies the card (and the pile or zone with it)
+// if shared, so read through a const frame when not going to modify it.
+// NOTE: Clones can be used from different threads, each clone by one thread.
+// Whatever clones share is only modified in place once no other clone holds
+// it, which is checked with acquire ordering against their releases.
+template<typename Card, typename CardBuilder = Detail::DefaultBuilder<Card>>
+class CowFrame
+{
+public:
+	using CardType = Card;
+	using PileType = std::vector<CardType*>;
+	using MaterialsType = std::vector<CardType*>;
+	using PlaceType = Proto::Duel::Place;
+
+	struct Zone
+	{
+		CardType* card{};
+		MaterialsType materials;
+	};
+
+	explicit CowFrame(CardBuilder const& builder = CardBuilder()) noexcept
+		: builder_(builder), root_(Shared<Root>::make())
+	{}
+
+	// NOTE: Moves are copies, so frames are never left without a root.
+	CowFrame(CowFrame const&) noexcept = default;
+	auto operator=(CowFrame const&) noexcept -> CowFrame& = default;
+
+	// Copy of this frame sharing everything with it, O(1).
+	[[nodiscard]] auto clone() const noexcept -> CowFrame { return *this; }
+
+	// Const getters.
+
+	[[nodiscard]] auto builder() const noexcept -> CardBuilder const&
+	{
+		return builder_;
+	}
+
+	template<typename Place>
+	[[nodiscard]] auto has_card(Place const& place) const noexcept -> bool
+	{
+		assert(!is_empty(place));
+		if(is_pile(place))
+			return place.seq() < pile(place).size();
+		assert(is_zone(place));
+		assert(place.seq() < zone_seq_lim(get_loc(place)));
+		auto const& z = zone(place);
+		if(place.oseq() < 0)
+			return z.card != nullptr;
+		return static_cast<size_t>(place.oseq()) < z.materials.size();
+	}
+
+	template<typename Place>
+	[[nodiscard]] auto card(Place const& place) const noexcept
+		-> CardType const&
+	{
+		assert(has_card(place));
+		if(is_pile(place))
+			return *pile(place)[place.seq()];
+		auto const& z = zone(place);
+		if(place.oseq() < 0)
+			return *z.card;
+		return *z.materials[place.oseq()];
+	}
+
+	[[nodiscard]] auto pile(Duel::Controller con,
+	                        Duel::Location loc) const noexcept
+		-> PileType const&
+	{
+		auto const& p = pile_ptr_(*root_, con, loc);
+		return (p != nullptr) ? p->cards : EMPTY_PILE;
+	}
+
+	template<typename Place>
+	[[nodiscard]] auto pile(Place const& place) const noexcept
+		-> PileType const&
+	{
+		return pile(get_con(place), get_loc(place));
+	}
+
+	[[nodiscard]] auto zone(Duel::Controller con, Duel::Location loc,
+	                        uint32_t seq) const noexcept -> Zone const&
+	{
+		auto const& z = zone_ptr_(*root_, con, loc, seq);
+		return (z != nullptr) ? z->zone : EMPTY_ZONE;
+	}
+
+	template<typename Place>
+	[[nodiscard]] auto zone(Place const& place) const noexcept -> Zone const&
+	{
+		return zone(get_con(place), get_loc(place), place.seq());
+	}
+
+	// Non-const getters.
+
+	template<typename Place>
+	[[nodiscard]] auto card(Place const& place) noexcept -> CardType&
+	{
+		assert(has_card(place));
+		auto& slot = slot_(place);
+		if(!Node::unique(slot))
+		{
+			auto* copy = new_node_();
+			Detail::copy_card_values<CardType>(*copy, *slot);
+			Node::release(std::exchange(slot, copy));
+		}
+		return *slot;
+	}
+
+	// Modifiers.
+
+	template<typename Place>
+	auto card_add(Place const& place) noexcept -> CardType&
+	{
+		CardType* c = new_node_();
+		if(is_pile(place))
+		{
+			auto& p = pile_(place);
+			assert(place.seq() <= p.size());
+			p.insert(p.begin() + place.seq(), c);
+			return *c;
+		}
+		auto& z = zone_(place);
+		if(place.oseq() < 0)
+		{
+			assert(z.card == nullptr);
+			z.card = c;
+			return *c;
+		}
+		assert(static_cast<size_t>(place.oseq()) <= z.materials.size());
+		z.materials.insert(z.materials.begin() + place.oseq(), c);
+		return *c;
+	}
+
+	// Same as calling `card_add` with every place of [first, last) in order,
+	// but piles grow (and are unshared) at most once.
+	template<typename ForwardIt>
+	auto cards_add(ForwardIt first, ForwardIt last) noexcept -> void
+	{
+		std::array<std::array<size_t, Detail::PILE_LOCATIONS.size()>,
+		           Duel::CONTROLLER_ARRAY_SIZE>
+			counts{};
+		for(auto it = first; it != last; ++it)
+		{
+			if(is_pile(*it))
+				counts[get_con(*it)][loc_index(get_loc(*it))]++;
+		}
+		auto& root = root_mut_();
+		for(size_t con = 0U; con < counts.size(); con++)
+		{
+			for(size_t i = 0U; i < counts[con].size(); i++)
+			{
+				if(counts[con][i] == 0U)
+					continue;
+				auto& p = unshare_(root.piles[con][i]).cards;
+				p.reserve(p.size() + counts[con][i]);
+			}
+		}
+		for(; first != last; ++first)
+			card_add(*first);
+	}
+
+	template<typename Place>
+	auto card_remove(Place const& place) noexcept -> void
+	{
+		assert(has_card(place));
+		Node::release(take_(place));
+	}
+
+	// NOTE: Unlike BasicFrame, the card moved is given back as const, as it
+	// may still be shared.
+	template<typename Place>
+	auto card_move(Place const& from, Place const& to) noexcept
+		-> CardType const&
+	{
+		assert(has_card(from));
+		// Do not refer to a material location while also being a pile.
+		assert(!is_pile(from) || from.oseq() < 0);
+		assert(!is_pile(to) || to.oseq() < 0);
+		// NOTE: Zone cards moving to empty zones take their materials along,
+		// which is the same as swapping both zones.
+		if(is_zone_card_(from) && is_zone_card_(to))
+		{
+			assert(!has_card(to) && zone(to).materials.empty());
+			auto& root = root_mut_();
+			std::swap(
+				zone_ptr_(root, get_con(from), get_loc(from), from.seq()),
+				zone_ptr_(root, get_con(to), get_loc(to), to.seq()));
+			return *zone(to).card;
+		}
+		CardType* c = take_(from);
+		if(is_pile(to))
+		{
+			auto& p = pile_(to);
+			p.insert(p.begin() + to.seq(), c);
+			return *c;
+		}
+		auto& z = zone_(to);
+		if(to.oseq() < 0)
+		{
+			assert(z.card == nullptr);
+			z.card = c;
+			return *c;
+		}
+		z.materials.insert(z.materials.begin() + to.oseq(), c);
+		return *c;
+	}
+
+	template<typename InputIt>
+	auto card_shuffle(InputIt previous, InputIt current, size_t count) noexcept
+		-> void
+	{
+		// NOTE: Same as BasicFrame, but whole zones are swapped by swapping
+		// their (shared) blocks, so none are copied.
+		assert(!is_pile(*previous));
+		constexpr size_t UPPER_BOUND =
+			zone_seq_lim(YGOpen::Duel::LOCATION_MONSTER_ZONE);
+		assert(count <= UPPER_BOUND);
+		std::array<uint32_t, UPPER_BOUND> seqs{};
+		for(size_t i = 0U; i < count; i++)
+		{
+			auto const& p = *previous++;
+			assert(has_card(p));
+			seqs[i] = p.seq();
+		}
+		auto& root = root_mut_();
+		for(size_t i = 0U; i < count; i++)
+		{
+			auto const& p = *current++;
+			if(is_empty(p))
+				continue;
+			auto const con = get_con(p);
+			auto const loc = get_loc(p);
+			std::swap(zone_ptr_(root, con, loc, seqs[i]),
+			          zone_ptr_(root, con, loc, p.seq()));
+			auto const seq = p.seq();
+			for(size_t j = 0U; j < count; j++)
+			{
+				if(seqs[j] != seq)
+					continue;
+				seqs[j] = seqs[i];
+				break;
+			}
+			seqs[i] = seq;
+		}
+	}
+
+	template<typename Place>
+	auto card_swap(Place const& a, Place const& b) noexcept -> void
+	{
+		assert(has_card(a));
+		assert(has_card(b));
+		// NOTE: Materials are swapped too when swapping zone cards.
+		if(is_zone_card_(a) && is_zone_card_(b))
+		{
+			auto& root = root_mut_();
+			std::swap(zone_ptr_(root, get_con(a), get_loc(a), a.seq()),
+			          zone_ptr_(root, get_con(b), get_loc(b), b.seq()));
+			return;
+		}
+		auto& sa = slot_(a);
+		auto& sb = slot_(b);
+		std::swap(sa, sb);
+	}
+
+	template<typename Place>
+	auto pile_resize(Place const& place, size_t count) noexcept -> void
+	{
+		assert(is_pile(place));
+		if(pile(place).size() == count)
+			return;
+		auto& p = pile_(place);
+		while(p.size() < count)
+			p.push_back(new_node_());
+		while(p.size() > count)
+		{
+			Node::release(p.back());
+			p.pop_back();
+		}
+	}
+
+	template<typename Place>
+	auto pile_splice(Place const& from, size_t count, Place const& to,
+	                 bool reverse) noexcept -> void
+	{
+		assert(is_pile(from));
+		assert(is_pile(to));
+		auto& pile_from = pile_(from);
+		assert(count + from.seq() <= pile_from.size());
+		PileType moved(pile_from.cbegin() + from.seq(),
+		               pile_from.cbegin() + from.seq() + count);
+		pile_from.erase(pile_from.cbegin() + from.seq(),
+		                pile_from.cbegin() + from.seq() + count);
+		if(reverse)
+			std::reverse(moved.begin(), moved.end());
+		auto& pile_to = pile_(to);
+		pile_to.insert(pile_to.begin() + to.seq(), moved.cbegin(),
+		               moved.cend());
+	}
+
+	template<typename Place>
+	auto pile_swap(Place const& a, Place const& b) noexcept -> void
+	{
+		assert(is_pile(a));
+		assert(is_pile(b));
+		auto& root = root_mut_();
+		std::swap(pile_ptr_(root, get_con(a), get_loc(a)),
+		          pile_ptr_(root, get_con(b), get_loc(b)));
+	}
+
+	auto clear() noexcept -> void { root_ = Shared<Root>::make(); }
+
+private:
+	// Reference counted pointer to a root or block, shared by the clones that
+	// have not modified it. Unlike std::shared_ptr::use_count, `unique` loads
+	// the count with acquire ordering, pairing with the release of clones that
+	// let go of it from other threads, so modifying in place is race-free.
+	template<typename T>
+	class Shared
+	{
+	public:
+		Shared() noexcept = default;
+
+		template<typename... Args>
+		[[nodiscard]] static auto make(Args&&... args) noexcept -> Shared
+		{
+			Shared s;
+			s.p_ = new Counted(std::forward<Args>(args)...);
+			return s;
+		}
+
+		Shared(Shared const& other) noexcept : p_(other.p_)
+		{
+			if(p_ != nullptr)
+				p_->refs.fetch_add(1U, std::memory_order_relaxed);
+		}
+
+		Shared(Shared&& other) noexcept : p_(std::exchange(other.p_, nullptr))
+		{}
+
+		auto operator=(Shared other) noexcept -> Shared&
+		{
+			std::swap(p_, other.p_);
+			return *this;
+		}
+
+		~Shared() noexcept
+		{
+			if(p_ != nullptr &&
+			   p_->refs.fetch_sub(1U, std::memory_order_acq_rel) == 1U)
+				delete p_;
+		}
+
+		[[nodiscard]] auto operator==(std::nullptr_t) const noexcept -> bool
+		{
+			return p_ == nullptr;
+		}
+
+		[[nodiscard]] auto operator!=(std::nullptr_t) const noexcept -> bool
+		{
+			return p_ != nullptr;
+		}
+
+		[[nodiscard]] auto operator*() const noexcept -> T&
+		{
+			return p_->value;
+		}
+
+		[[nodiscard]] auto operator->() const noexcept -> T*
+		{
+			return &p_->value;
+		}
+
+		[[nodiscard]] auto unique() const noexcept -> bool
+		{
+			return p_->refs.load(std::memory_order_acquire) == 1U;
+		}
+
+	private:
+		struct Counted
+		{
+			template<typename... Args>
+			explicit Counted(Args&&... args) noexcept
+				: value(std::forward<Args>(args)...)
+			{}
+
+			std::atomic<uint32_t> refs{1U};
+			T value;
+		};
+
+		Counted* p_{};
+	};
+
+	// Cards are reference counted by every pile and zone holding them.
+	struct Node : public CardType
+	{
+		std::atomic<uint32_t> refs;
+
+		explicit Node(CardType&& card) noexcept
+			: CardType(std::move(card)), refs(1U)
+		{}
+
+		static auto retain(CardType* c) noexcept -> void
+		{
+			static_cast<Node*>(c)->refs.fetch_add(1U,
+			                                      std::memory_order_relaxed);
+		}
+
+		static auto release(CardType* c) noexcept -> void
+		{
+			auto* n = static_cast<Node*>(c);
+			if(n->refs.fetch_sub(1U, std::memory_order_acq_rel) == 1U)
+				delete n;
+		}
+
+		[[nodiscard]] static auto unique(CardType const* c) noexcept -> bool
+		{
+			return static_cast<Node const*>(c)->refs.load(
+					   std::memory_order_acquire) == 1U;
+		}
+	};
+
+	struct PileBlock
+	{
+		PileType cards;
+
+		explicit PileBlock() noexcept = default;
+
+		PileBlock(PileBlock const& other) noexcept : cards(other.cards)
+		{
+			for(auto* c : cards)
+				Node::retain(c);
+		}
+
+		auto operator=(PileBlock const&) -> PileBlock& = delete;
+
+		~PileBlock() noexcept
+		{
+			for(auto* c : cards)
+				Node::release(c);
+		}
+	};
+
+	struct ZoneBlock
+	{
+		Zone zone;
+
+		explicit ZoneBlock() noexcept = default;
+
+		ZoneBlock(ZoneBlock const& other) noexcept : zone(other.zone)
+		{
+			if(zone.card != nullptr)
+				Node::retain(zone.card);
+			for(auto* c : zone.materials)
+				Node::retain(c);
+		}
+
+		auto operator=(ZoneBlock const&) -> ZoneBlock& = delete;
+
+		~ZoneBlock() noexcept
+		{
+			if(zone.card != nullptr)
+				Node::release(zone.card);
+			for(auto* c : zone.materials)
+				Node::release(c);
+		}
+	};
+
+	// NOTE: Empty piles and zones have no block.
+	struct Root
+	{
+		std::array<std::array<Shared<PileBlock>,
+		                      Detail::PILE_LOCATIONS.size()>,
+		           Duel::CONTROLLER_ARRAY_SIZE>
+			piles;
+		std::array<std::array<Shared<ZoneBlock>, Detail::ZONE_COUNT>,
+		           Duel::CONTROLLER_ARRAY_SIZE>
+			zones;
+	};
+
+	static inline PileType const EMPTY_PILE{};
+	static inline Zone const EMPTY_ZONE{};
+
+	CardBuilder builder_;
+	Shared<Root> root_;
+
+	template<typename Place>
+	static auto is_zone_card_(Place const& place) noexcept -> bool
+	{
+		return !is_pile(place) && place.oseq() < 0;
+	}
+
+	template<typename R>
+	static auto pile_ptr_(R& root, Duel::Controller con,
+	                      Duel::Location loc) noexcept -> auto&
+	{
+		assert(con <= 1);
+		assert(is_pile(loc));
+		return root.piles[con][loc_index(loc)];
+	}
+
+	template<typename R>
+	static auto zone_ptr_(R& root, Duel::Controller con, Duel::Location loc,
+	                      uint32_t seq) noexcept -> auto&
+	{
+		assert(con <= 1);
+		return root.zones[con][zone_index(loc, seq)];
+	}
+
+	// Makes `block` only owned by this frame, copying it if shared.
+	template<typename Block>
+	static auto unshare_(Shared<Block>& block) noexcept -> Block&
+	{
+		if(block == nullptr)
+			block = Shared<Block>::make();
+		else if(!block.unique())
+			block = Shared<Block>::make(*block);
+		return *block;
+	}
+
+	[[nodiscard]] auto root_mut_() noexcept -> Root&
+	{
+		return unshare_(root_);
+	}
+
+	template<typename Place>
+	[[nodiscard]] auto pile_(Place const& place) noexcept -> PileType&
+	{
+		auto& root = root_mut_();
+		return unshare_(pile_ptr_(root, get_con(place), get_loc(place))).cards;
+	}
+
+	template<typename Place>
+	[[nodiscard]] auto zone_(Place const& place) noexcept -> Zone&
+	{
+		auto& root = root_mut_();
+		auto& z = zone_ptr_(root, get_con(place), get_loc(place), place.seq());
+		return unshare_(z).zone;
+	}
+
+	// Where the card at `place` is kept, no longer shared with other frames.
+	template<typename Place>
+	[[nodiscard]] auto slot_(Place const& place) noexcept -> CardType*&
+	{
+		if(is_pile(place))
+			return pile_(place)[place.seq()];
+		auto& z = zone_(place);
+		if(place.oseq() < 0)
+			return z.card;
+		return z.materials[place.oseq()];
+	}
+
+	template<typename Place>
+	[[nodiscard]] auto take_(Place const& place) noexcept -> CardType*
+	{
+		if(is_pile(place))
+		{
+			auto& p = pile_(place);
+			auto* c = p[place.seq()];
+			p.erase(p.begin() + place.seq());
+			return c;
+		}
+		auto& z = zone_(place);
+		if(place.oseq() < 0)
+			return std::exchange(z.card, nullptr);
+		auto* c = z.materials[place.oseq()];
+		z.materials.erase(z.materials.begin() + place.oseq());
+		return c;
+	}
+
+	[[nodiscard]] auto new_node_() noexcept -> CardType*
+	{
+		return new Node(builder_.build());
+	}
+};
+
+} // namespace YGOpen::Client
+
+#endif // YGOPEN_CLIENT_FRAME_COW_HPP
@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_CLIENT_FRAME_HASHED_HPP
+#define YGOPEN_CLIENT_FRAME_HASHED_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <ygopen/client/frame.hpp>
+#include <ygopen/client/parse_query.hpp>
+#include <ygopen/client/state_hash.hpp>
+#include <ygopen/proto/duel/msg.hpp>
+
+namespace YGOpen::Client
+{
+
+// Frame that keeps a hash of all its cards and where they are, updated on
+// every modification instead of walking the whole frame, so two frames can be
+// cheaply checked for being in the same state (for instance, a server's and a
+// client's after each message).
+//
+// The hash is the XOR of the contributions of every pile, zone card and
+// zone's materials, which are a slot key mixed with how many cards they hold
+// and the hashes of those cards. Zone cards and materials are kept as a sum of
+// their hashes, updated in O(1) (plus hashing the card) on every change, as
+// where they are is already part of the slot. Piles hash their cards in order
+// instead, which is only redone by `state_hash` for those that changed since
+// it was last called, so changing a pile is O(1) as well.
+//
+// NOTE: Card values changed other than through `card_update` (which
+// `parse_query` on this frame uses) are not seen by the hash until `rehash`.
+template<typename Card, typename CardBuilder = Detail::DefaultBuilder<Card>,
+         typename CardStorage = ListCardStorage<Card>,
+         typename PileStorage = VectorPileStorage<Card>,
+         typename CardHasher = CardValuesHasher>
+class HashedFrame
+	: public BasicFrame<Card, CardBuilder, CardStorage, PileStorage>
+{
+public:
+	using BaseFrame = BasicFrame<Card, CardBuilder, CardStorage, PileStorage>;
+	using CardType = typename BaseFrame::CardType;
+
+	explicit constexpr HashedFrame(
+		CardBuilder const& builder = CardBuilder(),
+		CardHasher const& hasher = CardHasher()) noexcept
+		: BaseFrame(builder)
+		, hasher_(hasher)
+		, hash_(0U)
+		, sums_()
+		, piles_hash_(0U)
+		, pile_hashes_()
+		, dirty_()
+	{}
+
+	// Hash of every card of the frame and where it is. Empty frames hash to 0.
+	//
+	// NOTE: Piles changed since the last call are hashed again here, which is
+	// O(n) in the cards they hold, so this is not safe to call concurrently.
+	[[nodiscard]] constexpr auto state_hash() const noexcept -> uint64_t
+	{
+		for(auto con : {Duel::CONTROLLER_0, Duel::CONTROLLER_1})
+		{
+			for(size_t i = 0U; i < ZONES; i++)
+			{
+				if(dirty_[con][i])
+					rehash_pile_({con, i});
+			}
+		}
+		return hash_ ^ piles_hash_;
+	}
+
+	// Calls `f` with this frame, as a BaseFrame, so that it changes the values
+	// of the card at `place`. Returns whatever `f` returns.
+	template<typename Place, typename F>
+	constexpr auto card_update(Place const& place, F&& f) noexcept
+	{
+		auto const s = slot_(place);
+		auto const old_sum = card_sum_(BaseFrame::card(place));
+		auto rehash = [&]()
+		{
+			set_sum_(s, sum_(s) - old_sum + card_sum_(BaseFrame::card(place)));
+		};
+		if constexpr(std::is_void_v<decltype(f(std::declval<BaseFrame&>()))>)
+		{
+			f(static_cast<BaseFrame&>(*this));
+			rehash();
+		}
+		else
+		{
+			auto result = f(static_cast<BaseFrame&>(*this));
+			rehash();
+			return result;
+		}
+	}
+
+	// Modifiers.
+
+	template<typename Place>
+	constexpr auto card_add(Place const& place) noexcept -> CardType&
+	{
+		auto& c = BaseFrame::card_add(place);
+		auto const s = slot_(place);
+		set_sum_(s, sum_(s) + card_sum_(c));
+		return c;
+	}
+
+	template<typename ForwardIt>
+	constexpr auto cards_add(ForwardIt first, ForwardIt last) noexcept -> void
+	{
+		BaseFrame::pile_reserve(first, last);
+		for(; first != last; ++first)
+			card_add(*first);
+	}
+
+	template<typename Place>
+	constexpr auto card_remove(Place const& place) noexcept -> void
+	{
+		auto const s = slot_(place);
+		set_sum_(s, sum_(s) - card_sum_(BaseFrame::card(place)));
+		BaseFrame::card_remove(place);
+	}
+
+	template<typename Place>
+	constexpr auto card_move(Place const& from, Place const& to) noexcept
+		-> CardType&
+	{
+		auto const h = card_sum_(BaseFrame::card(from));
+		// NOTE: Materials go along when moving between zones.
+		if(is_zone_card_(from) && is_zone_card_(to))
+		{
+			auto const mf = slot_(from, true);
+			auto const mt = slot_(to, true);
+			auto const materials = sum_(mf);
+			set_sum_(mf, {});
+			set_sum_(mt, sum_(mt) + materials);
+		}
+		auto const sf = slot_(from);
+		set_sum_(sf, sum_(sf) - h);
+		auto const st = slot_(to);
+		set_sum_(st, sum_(st) + h);
+		return BaseFrame::card_move(from, to);
+	}
+
+	template<typename InputIt>
+	constexpr auto card_shuffle(InputIt previous, InputIt current,
+	                            size_t count) noexcept -> void
+	{
+		if(count == 0U)
+			return;
+		auto const con = get_con(*previous);
+		auto const loc = get_loc(*previous);
+		BaseFrame::card_shuffle(previous, current, count);
+		// NOTE: Whole zones are swapped around, so the (few) zones of the
+		// location are hashed again.
+		for(uint32_t seq = 0U; seq < zone_seq_lim(loc); seq++)
+		{
+			auto const& z = BaseFrame::zone(con, loc, seq);
+			auto const i = zone_index(loc, seq);
+			set_sum_({con, ZONES + i},
+			         (z.card != nullptr) ? card_sum_(*z.card) : Sum{});
+			Sum materials{};
+			for(auto const* c : z.materials)
+				materials = materials + card_sum_(*c);
+			set_sum_({con, MATERIALS + i}, materials);
+		}
+	}
+
+	template<typename Place>
+	constexpr auto card_swap(Place const& a, Place const& b) noexcept -> void
+	{
+		auto const ha = card_sum_(BaseFrame::card(a));
+		auto const hb = card_sum_(BaseFrame::card(b));
+		// NOTE: Materials are swapped too when swapping zones.
+		if(is_zone_card_(a) && is_zone_card_(b))
+		{
+			auto const ma = slot_(a, true);
+			auto const mb = slot_(b, true);
+			auto const materials_a = sum_(ma);
+			set_sum_(ma, sum_(mb));
+			set_sum_(mb, materials_a);
+		}
+		auto const sa = slot_(a);
+		set_sum_(sa, sum_(sa) - ha + hb);
+		auto const sb = slot_(b);
+		set_sum_(sb, sum_(sb) - hb + ha);
+		BaseFrame::card_swap(a, b);
+	}
+
+	template<typename Place>
+	constexpr auto pile_resize(Place const& place, size_t count) noexcept
+		-> void
+	{
+		set_sum_(slot_(place), {});
+		BaseFrame::pile_resize(place, count);
+	}
+
+	template<typename Place>
+	constexpr auto pile_splice(Place const& from, size_t count,
+	                           Place const& to, bool reverse) noexcept
+		-> void
+	{
+		set_sum_(slot_(from), {});
+		set_sum_(slot_(to), {});
+		BaseFrame::pile_splice(from, count, to, reverse);
+	}
+
+	template<typename Place>
+	constexpr auto pile_swap(Place const& a, Place const& b) noexcept -> void
+	{
+		set_sum_(slot_(a), {});
+		set_sum_(slot_(b), {});
+		BaseFrame::pile_swap(a, b);
+	}
+
+	constexpr auto clear() noexcept -> void
+	{
+		BaseFrame::clear();
+		hash_ = 0U;
+		sums_ = {};
+		piles_hash_ = 0U;
+		pile_hashes_ = {};
+		dirty_ = {};
+	}
+
+	// Hashes every card again, for when their values were written without
+	// going through `card_update` (see `restore_snapshot`). O(n).
+	constexpr auto rehash() noexcept -> void
+	{
+		hash_ = 0U;
+		sums_ = {};
+		decltype(sums_) sums{};
+		// NOTE: Piles only get marked as changed here.
+		auto add = [&](PlaceValue const& place, CardType const& c)
+		{
+			auto const s = slot_(place);
+			sums[s.con][s.index] = sums[s.con][s.index] + card_sum_(c);
+		};
+		Detail::for_each_card(static_cast<BaseFrame const&>(*this), add);
+		for(auto con : {Duel::CONTROLLER_0, Duel::CONTROLLER_1})
+		{
+			for(size_t i = 0U; i < SLOT_COUNT; i++)
+				set_sum_({con, i}, sums[con][i]);
+		}
+	}
+
+private:
+	// Piles, then zone cards, then zone materials, of a single controller.
+	static constexpr size_t ZONES = Detail::PILE_LOCATIONS.size();
+	static constexpr size_t MATERIALS = ZONES + Detail::ZONE_COUNT;
+	static constexpr size_t SLOT_COUNT = MATERIALS + Detail::ZONE_COUNT;
+
+	struct Slot
+	{
+		Duel::Controller con;
+		size_t index;
+	};
+
+	// Wrapping sum of the hashes of the cards in a slot, and their amount.
+	struct Sum
+	{
+		uint64_t hashes;
+		uint64_t count;
+
+		constexpr auto operator+(Sum const& other) const noexcept -> Sum
+		{
+			return {hashes + other.hashes, count + other.count};
+		}
+
+		constexpr auto operator-(Sum const& other) const noexcept -> Sum
+		{
+			return {hashes - other.hashes, count - other.count};
+		}
+	};
+
+	CardHasher hasher_;
+	uint64_t hash_;
+	std::array<std::array<Sum, SLOT_COUNT>, Duel::CONTROLLER_ARRAY_SIZE> sums_;
+	// Piles are hashed lazily by `state_hash`, hence mutable.
+	mutable uint64_t piles_hash_;
+	mutable std::array<std::array<uint64_t, ZONES>,
+	                   Duel::CONTROLLER_ARRAY_SIZE>
+		pile_hashes_;
+	mutable std::array<std::array<bool, ZONES>, Duel::CONTROLLER_ARRAY_SIZE>
+		dirty_;
+
+	[[nodiscard]] constexpr auto card_sum_(CardType const& c) const noexcept
+		-> Sum
+	{
+		return {hasher_(c), 1U};
+	}
+
+	template<typename Place>
+	static constexpr auto is_zone_card_(Place const& place) noexcept -> bool
+	{
+		return !is_pile(place) && place.oseq() < 0;
+	}
+
+	// Slot of the card at `place`, or of the materials of its zone.
+	template<typename Place>
+	static constexpr auto slot_(Place const& place,
+	                            bool materials = false) noexcept -> Slot
+	{
+		auto const con = get_con(place);
+		auto const loc = get_loc(place);
+		if(is_pile(loc))
+			return {con, loc_index(loc)};
+		auto const i = zone_index(loc, place.seq());
+		bool const is_mat = materials || place.oseq() >= 0;
+		return {con, (is_mat ? MATERIALS : ZONES) + i};
+	}
+
+	[[nodiscard]] constexpr auto sum_(Slot s) const noexcept -> Sum
+	{
+		return sums_[s.con][s.index];
+	}
+
+	[[nodiscard]] static constexpr auto slot_seed_(Slot s,
+	                                               uint64_t count) noexcept
+		-> uint64_t
+	{
+		auto const key = s.con * SLOT_COUNT + s.index + 1U;
+		return Detail::hash_combine(Detail::hash_mix(key), count);
+	}
+
+	// NOTE: Only the contribution of the slot changed is redone, O(1). Piles
+	// are only marked as changed, their sums are never kept.
+	constexpr auto set_sum_(Slot s, Sum sum) noexcept -> void
+	{
+		if(s.index < ZONES)
+		{
+			dirty_[s.con][s.index] = true;
+			return;
+		}
+		auto contribution = [s](Sum const& v) -> uint64_t
+		{
+			if(v.count == 0U)
+				return 0U;
+			return Detail::hash_combine(slot_seed_(s, v.count), v.hashes);
+		};
+		auto& old_sum = sums_[s.con][s.index];
+		hash_ ^= contribution(old_sum) ^ contribution(sum);
+		old_sum = sum;
+	}
+
+	// Hashes the cards of a pile in order. O(n).
+	constexpr auto rehash_pile_(Slot s) const noexcept -> void
+	{
+		auto const& p = BaseFrame::pile(s.con, Detail::PILE_LOCATIONS[s.index]);
+		uint64_t h = 0U;
+		if(p.size() != 0U)
+		{
+			h = slot_seed_(s, p.size());
+			for(size_t i = 0U; i < p.size(); i++)
+				h = Detail::hash_combine(h, hasher_(*p[i]));
+		}
+		auto& old_h = pile_hashes_[s.con][s.index];
+		piles_hash_ ^= old_h ^ h;
+		old_h = h;
+		dirty_[s.con][s.index] = false;
+	}
+};
+
+// Same as the generic `parse_query`, but keeping the frame's hash up to date.
+template<bool use_cache = false, typename Card, typename CardBuilder,
+         typename CardStorage, typename PileStorage, typename CardHasher>
+[[nodiscard]] auto parse_query(
+	HashedFrame<Card, CardBuilder, CardStorage, PileStorage, CardHasher>&
+		frame,
+	Proto::Duel::Msg::Query const& query) noexcept -> QueryCacheHit
+{
+	return frame.card_update(query.place(),
+	                         [&query](auto& base)
+	                         { return parse_query<use_cache>(base, query); });
+}
+
+} // namespace YGOpen::Client
+
+#endif // YGOPEN_CLIENT_FRAME_HASHED_HPP
@@ -5,8 +5,13 @@
  */
 #ifndef YGOPEN_CLIENT_FRAME_LIMBO_HPP
 #define YGOPEN_CLIENT_FRAME_LIMBO_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
+#include <utility>
 #include <variant>
+#include <vector>
 #include <ygopen/client/frame.hpp>
 
 // TODO: Unit test undo specialized operations.
@@ -14,17 +19,46 @@
 namespace YGOpen::Client
 {
 
-template<typename Card, typename CardBuilder = Detail::DefaultBuilder<Card>>
-class LimboFrame : public BasicFrame<Card, CardBuilder>
+namespace Detail
+{
+
+// Range of cards of a frame layout and where they go: a pile, or a zone
+// followed by its materials. Empty piles and zones have no run.
+struct LayoutRun
+{
+	uint8_t con;
+	uint8_t seq;
+	uint16_t loc;
+	uint32_t size;
+};
+
+} // namespace Detail
+
+template<typename Card, typename CardBuilder = Detail::DefaultBuilder<Card>,
+         typename CardStorage = ListCardStorage<Card>,
+         typename PileStorage = VectorPileStorage<Card>>
+class LimboFrame
+	: public BasicFrame<Card, CardBuilder, CardStorage, PileStorage>
 {
 public:
-	using BaseFrame = BasicFrame<Card, CardBuilder>;
+	using BaseFrame = BasicFrame<Card, CardBuilder, CardStorage, PileStorage>;
 	using PileType = typename BaseFrame::PileType;
 	using PlaceType = typename BaseFrame::PlaceType;
 	using FieldType = typename BaseFrame::FieldType;
+	using OperationCountType = size_t;
+
+	static constexpr size_t UNLIMITED_HISTORY = SIZE_MAX;
 
 	explicit constexpr LimboFrame(CardBuilder const& builder = CardBuilder())
-		: BaseFrame(builder), op_(0U), processed_op_(0U)
+		: BaseFrame(builder)
+		, op_(0U)
+		, processed_op_(0U)
+		, dropped_op_(0U)
+		, limit_(UNLIMITED_HISTORY)
+		, arena_base_(0U)
+		, arena_dead_(0U)
+		, run_base_(0U)
+		, run_dead_(0U)
 	{}
 
 	// Specialized operations.
@@ -35,19 +69,51 @@ public:
 	{
 		if(op_ == processed_op_)
 			return;
-		assert(op_ <= operations_.size());
 		assert(op_ < processed_op_);
-		// TODO: Destruct limbo cards.
-		operations_.resize(op_);
-		processed_op_ = op_;
+		forget_ops_from_(op_);
+	}
+
+	// History.
+
+	[[nodiscard]] constexpr auto history_limit() const noexcept -> size_t
+	{
+		return limit_;
+	}
+
+	// Forgets the oldest operations (and if still needed the undone ones) so
+	// that no more than `limit` are kept. Cards only kept alive by forgotten
+	// operations are destroyed.
+	constexpr auto set_history_limit(size_t limit) noexcept -> void
+	{
+		assert(limit > 0U);
+		limit_ = limit;
+		while(operations_.size() > limit_ && dropped_op_ != op_)
+			drop_oldest_op_();
+		if(operations_.size() > limit_)
+			forget_ops_from_(dropped_op_ + limit_);
+	}
+
+	// Amount of operations kept.
+	[[nodiscard]] constexpr auto history_size() const noexcept -> size_t
+	{
+		return operations_.size();
+	}
+
+	// Bytes used to keep the operations, not counting cards in limbo.
+	[[nodiscard]] constexpr auto memory_usage() const noexcept -> size_t
+	{
+		return operations_.size() * sizeof(Ops) +
+		       arena_.capacity() * sizeof(Card*) +
+		       runs_.capacity() * sizeof(Detail::LayoutRun);
 	}
 
-	constexpr auto card_add(PlaceType const& place) noexcept -> Card&
+	template<typename Place>
+	constexpr auto card_add(Place const& place) noexcept -> Card&
 	{
 		if(advance_op_())
 		{
 			auto& c = BaseFrame::card_add(place);
-			emplace_op_<CardOp>().card = &c;
+			emplace_op_<CardOp>() = {&c, true};
 			return c;
 		}
 		auto& c = *current_op_as_card_();
@@ -56,73 +122,129 @@ public:
 		return c;
 	}
 
-	constexpr auto card_remove(PlaceType const& place) noexcept -> void
+	template<typename ForwardIt>
+	constexpr auto cards_add(ForwardIt first, ForwardIt last) noexcept -> void
+	{
+		BaseFrame::pile_reserve(first, last);
+		for(; first != last; ++first)
+			card_add(*first);
+	}
+
+	template<typename Place>
+	constexpr auto card_remove(Place const& place) noexcept -> void
 	{
 		assert(this->has_card(place));
 		auto& c = BaseFrame::card_erase(place);
 		if(advance_op_())
 		{
-			emplace_op_<CardOp>().card = &c;
+			emplace_op_<CardOp>() = {&c, false};
 			return;
 		}
 		assert(current_op_as_card_() == &c);
 	}
 
-	constexpr auto pile_resize(PlaceType const& place, size_t count) noexcept
+	template<typename Place>
+	constexpr auto pile_resize(Place const& place, size_t count) noexcept
 		-> void
 	{
 		assert(is_pile(place));
-		bool processing = advance_op_();
 		auto& p = this->pile(place);
-		auto& rsz_op = [&]() -> ResizeOp&
-		{
-			if(processing)
-				return emplace_op_<ResizeOp>();
-			assert(operations_.size() >= op_);
-			assert(std::holds_alternative<ResizeOp>(operations_[op_ - 1]));
-			return std::get<ResizeOp>(operations_[op_ - 1]);
-		}();
-		rsz_op.prev_size = p.size();
-		if(p.size() < count)
+		if(advance_op_())
 		{
-			if(processing)
-			{
-				for(size_t i = count - p.size(); i != 0; i--)
-					p.push_back(&BaseFrame::construct_card());
-			}
-			else
-			{
-				p.insert(p.end(), rsz_op.slice.cbegin(), rsz_op.slice.cend());
-			}
+			auto& rsz_op = emplace_op_<ResizeOp>();
+			rsz_op.prev_size = to_u32_(p.size());
+			rsz_op.count = to_u32_(count);
+			for(size_t i = p.size(); i < count; i++)
+				p.push_back(&BaseFrame::construct_card());
+			// NOTE: Cards past the smaller of both sizes are kept for as long
+			// as the operation, so that both undoing and redoing it are only
+			// a matter of inserting or dropping them.
+			auto const kept = std::min<size_t>(rsz_op.prev_size, count);
+			rsz_op.offset = to_u32_(arena_base_ + arena_.size());
+			arena_.insert(arena_.end(), p.cbegin() + kept, p.cend());
 		}
-		else if(p.size() > count)
+		resize_to_(p, current_op_<ResizeOp>(), count);
+	}
+
+	constexpr auto clear() noexcept -> void
+	{
+		if(advance_op_())
 		{
-			size_t diff = p.size() - count;
-			rsz_op.slice.resize(diff);
-			std::copy(p.cbegin() + diff, p.cend(), rsz_op.slice.begin());
-			p.resize(count);
+			auto& clear_op = emplace_op_<ClearOp>();
+			clear_op.run_offset = to_u32_(run_base_ + runs_.size());
+			clear_op.card_offset = to_u32_(arena_base_ + arena_.size());
+			auto const first_run = runs_.size();
+			encode_layout_(runs_, arena_);
+			clear_op.run_count = to_u32_(runs_.size() - first_run);
 		}
-		assert(p.size() == count);
-		this->verify_pile_(p);
+		// NOTE: The operation keeps the cards, so they are just dropped.
+		drop_layout_();
 	}
 
-	constexpr auto clear() noexcept -> void
+	// Random access.
+
+	// Compact copy of where every card is at a given operation.
+	class Checkpoint
 	{
-		bool processing = advance_op_();
-		auto& clear_op = [&]() -> ClearOp&
+	public:
+		[[nodiscard]] auto operation() const noexcept -> OperationCountType
 		{
-			if(processing)
-				return emplace_op_<ClearOp>();
-			assert(operations_.size() >= op_);
-			assert(std::holds_alternative<ClearOp>(operations_[op_ - 1]));
-			return std::get<ClearOp>(operations_[op_ - 1]);
-		}();
-		swap_clear_op_(clear_op);
+			return op_;
+		}
+
+	private:
+		friend LimboFrame;
+
+		OperationCountType op_{};
+		size_t rewrites_{}; // Rewrites of the history it has seen.
+		std::vector<Detail::LayoutRun> runs_;
+		std::vector<Card*> cards_;
+	};
+
+	// Index of the current operation, any operation below it has been done.
+	[[nodiscard]] constexpr auto operation() const noexcept
+		-> OperationCountType
+	{
+		return op_;
+	}
+
+	[[nodiscard]] auto checkpoint() const noexcept -> Checkpoint
+	{
+		Checkpoint cp;
+		cp.op_ = op_;
+		cp.rewrites_ = rewrites_.size();
+		encode_layout_(cp.runs_, cp.cards_);
+		return cp;
+	}
+
+	// Whether `cp` can be restored: its operation is still in the history,
+	// and no operation it depends on was forgotten and recorded anew since.
+	[[nodiscard]] auto can_restore(Checkpoint const& cp) const noexcept -> bool
+	{
+		if(cp.op_ < dropped_op_ || cp.op_ > processed_op_)
+			return false;
+		return std::all_of(rewrites_.cbegin() + cp.rewrites_, rewrites_.cend(),
+		                   [&cp](auto first) { return cp.op_ <= first; });
+	}
+
+	// Puts every card back where it was when `cp` was taken, same as undoing
+	// or redoing all the operations in between. Returns false, leaving the
+	// frame untouched, if `cp` cannot be restored (see `can_restore`), as
+	// the cards it refers to may no longer exist.
+	[[nodiscard]] auto restore(Checkpoint const& cp) noexcept -> bool
+	{
+		if(!can_restore(cp))
+			return false;
+		drop_layout_();
+		decode_layout_(cp.runs_.cbegin(), cp.runs_.cend(), cp.cards_.cbegin());
+		op_ = cp.op_;
+		return true;
 	}
 
 	// Undo operations.
 
-	constexpr auto undo_card_add(PlaceType const& place) noexcept -> Card&
+	template<typename Place>
+	constexpr auto undo_card_add(Place const& place) noexcept -> Card&
 	{
 		assert(this->has_card(place));
 		auto& c = BaseFrame::card_erase(place);
@@ -131,7 +253,8 @@ public:
 		return c;
 	}
 
-	constexpr auto undo_card_remove(PlaceType const& place) noexcept -> Card&
+	template<typename Place>
+	constexpr auto undo_card_remove(Place const& place) noexcept -> Card&
 	{
 		auto& c = *current_op_as_card_();
 		BaseFrame::card_insert(place, c);
@@ -140,44 +263,25 @@ public:
 		return c;
 	}
 
-	constexpr auto undo_pile_resize(PlaceType const& place,
+	template<typename Place>
+	constexpr auto undo_pile_resize(Place const& place,
 	                                [[maybe_unused]] size_t count) noexcept
 		-> void
 	{
 		assert(is_pile(place));
 		auto& p = this->pile(place);
-		auto& rsz_op = [&]() -> ResizeOp&
-		{
-			assert(operations_.size() >= op_);
-			assert(std::holds_alternative<ResizeOp>(operations_[op_ - 1]));
-			return std::get<ResizeOp>(operations_[op_ - 1]);
-		}();
-		if(p.size() < rsz_op.prev_size)
-		{
-			p.insert(p.end(), rsz_op.slice.cbegin(), rsz_op.slice.cend());
-		}
-		else if(p.size() > rsz_op.prev_size)
-		{
-			size_t diff = p.size() - rsz_op.prev_size;
-			rsz_op.slice.resize(diff);
-			std::copy(p.cbegin() + p.size() - diff, p.cend(),
-			          rsz_op.slice.begin());
-			p.resize(rsz_op.prev_size);
-		}
+		auto const& rsz_op = current_op_<ResizeOp>();
+		assert(p.size() == count);
+		resize_to_(p, rsz_op, rsz_op.prev_size);
 		regress_op_();
-		assert(p.size() == rsz_op.prev_size);
-		this->verify_pile_(p);
 	}
 
 	constexpr auto undo_clear() noexcept -> void
 	{
-		auto& clear_op = [&]() -> ClearOp&
-		{
-			assert(operations_.size() >= op_);
-			assert(std::holds_alternative<ClearOp>(operations_[op_ - 1]));
-			return std::get<ClearOp>(operations_[op_ - 1]);
-		}();
-		swap_clear_op_(clear_op);
+		auto const& clear_op = current_op_<ClearOp>();
+		auto const runs = run_at_(clear_op.run_offset);
+		decode_layout_(runs, runs + clear_op.run_count,
+		               arena_at_(clear_op.card_offset));
 		regress_op_();
 	}
 
@@ -189,35 +293,55 @@ public:
 	}
 
 private:
-	using MultiPile = std::array<PileType, Duel::CONTROLLER_ARRAY_SIZE>;
+	// NOTE: Cards kept by operations live in `arena_` (and where they go in
+	// `runs_`), operations only refer to them by offset. Both only grow at
+	// their end, in the same order operations are recorded. Offsets count
+	// from the first element ever added, as forgetting the oldest operations
+	// eventually removes their elements from the front.
 
 	struct CardOp
 	{
 		Card* card;
+		bool added;
 	};
 
 	struct ResizeOp
 	{
-		size_t prev_size;
-		PileType slice;
+		uint32_t prev_size;
+		uint32_t count;
+		uint32_t offset;
+
+		[[nodiscard]] constexpr auto slice_size() const noexcept -> uint32_t
+		{
+			return (prev_size < count) ? count - prev_size : prev_size - count;
+		}
 	};
 
 	struct ClearOp
 	{
-		MultiPile main_deck;
-		MultiPile hand;
-		MultiPile graveyard;
-		MultiPile banished;
-		MultiPile extra_deck;
-		FieldType field;
+		uint32_t run_offset;
+		uint32_t run_count;
+		uint32_t card_offset;
 	};
 
+	// NOTE: Operations are never modified after being recorded, so the frame
+	// can jump between them just by restoring where its cards are.
 	using Ops = std::variant<CardOp, ResizeOp, ClearOp>;
-	using OperationCountType = std::deque<Ops>::size_type;
 
 	OperationCountType op_;
 	OperationCountType processed_op_;
+	OperationCountType dropped_op_; // Oldest operations forgotten.
+	// First operation forgotten by each `forget_ops_from_`, checkpoints
+	// past it taken before are stale.
+	std::vector<OperationCountType> rewrites_;
+	size_t limit_;
 	std::deque<Ops> operations_;
+	std::vector<Card*> arena_;
+	size_t arena_base_; // Offset of the first element of `arena_`.
+	size_t arena_dead_; // Offset past the elements of forgotten operations.
+	std::vector<Detail::LayoutRun> runs_;
+	size_t run_base_;
+	size_t run_dead_;
 
 	constexpr auto advance_op_() noexcept -> bool
 	{
@@ -226,36 +350,238 @@ private:
 
 	constexpr auto regress_op_() noexcept -> void
 	{
-		assert(op_ > 0);
+		assert(op_ > dropped_op_);
 		op_--;
 	}
 
-	constexpr auto swap_clear_op_(ClearOp& clear_op) noexcept -> void
+	static constexpr auto to_u32_(size_t v) noexcept -> uint32_t
+	{
+		assert(v <= UINT32_MAX);
+		return static_cast<uint32_t>(v);
+	}
+
+	// Appends a run, and its cards, for every pile and zone with cards.
+	auto encode_layout_(std::vector<Detail::LayoutRun>& runs,
+	                    std::vector<Card*>& cards) const noexcept -> void
 	{
 		using namespace YGOpen::Duel;
-		auto swap_multi_pile = [this](Location loc, MultiPile& p)
+		for(auto con : {CONTROLLER_0, CONTROLLER_1})
 		{
-			for(auto con : {CONTROLLER_0, CONTROLLER_1})
-				std::swap(this->pile(con, loc), p[con]);
-		};
-		swap_multi_pile(LOCATION_MAIN_DECK, clear_op.main_deck);
-		swap_multi_pile(LOCATION_HAND, clear_op.hand);
-		swap_multi_pile(LOCATION_GRAVEYARD, clear_op.graveyard);
-		swap_multi_pile(LOCATION_BANISHED, clear_op.banished);
-		swap_multi_pile(LOCATION_EXTRA_DECK, clear_op.extra_deck);
-		std::swap(this->field(), clear_op.field);
+			auto const c = static_cast<uint8_t>(con);
+			for(auto loc : Detail::PILE_LOCATIONS)
+			{
+				auto const& p = this->pile(con, loc);
+				if(p.empty())
+					continue;
+				runs.push_back({c, 0U, static_cast<uint16_t>(loc),
+				                to_u32_(p.size())});
+				cards.insert(cards.end(), p.cbegin(), p.cend());
+			}
+			for(auto loc : Detail::ZONE_LOCATIONS)
+			{
+				for(uint32_t seq = 0U; seq < zone_seq_lim(loc); seq++)
+				{
+					auto const& z = this->zone(con, loc, seq);
+					if(z.card == nullptr && z.materials.empty())
+						continue;
+					runs.push_back({c, static_cast<uint8_t>(seq),
+					                static_cast<uint16_t>(loc),
+					                to_u32_(1U + z.materials.size())});
+					cards.push_back(z.card);
+					cards.insert(cards.end(), z.materials.cbegin(),
+					             z.materials.cend());
+				}
+			}
+		}
+	}
+
+	// Puts back the cards of the given runs, the frame must be empty.
+	template<typename RunIt, typename CardIt>
+	auto decode_layout_(RunIt first, RunIt last, CardIt card) noexcept -> void
+	{
+		using namespace YGOpen::Duel;
+		for(; first != last; ++first)
+		{
+			auto const con = Controller{first->con};
+			auto const loc = Location{first->loc};
+			if(YGOpen::Duel::is_pile(loc))
+			{
+				auto& p = this->pile(con, loc);
+				assert(p.empty());
+				p.assign(card, card + first->size);
+				this->verify_pile_(p);
+			}
+			else
+			{
+				auto& z = this->zone(con, loc, first->seq);
+				assert(z.card == nullptr && z.materials.empty());
+				z.card = *card;
+				z.materials.assign(card + 1, card + first->size);
+			}
+			card += first->size;
+		}
+	}
+
+	// Empties every pile and zone, without destroying any card.
+	auto drop_layout_() noexcept -> void
+	{
+		using namespace YGOpen::Duel;
+		for(auto con : {CONTROLLER_0, CONTROLLER_1})
+		{
+			for(auto loc : Detail::PILE_LOCATIONS)
+				this->pile(con, loc).clear();
+			for(auto loc : Detail::ZONE_LOCATIONS)
+			{
+				for(uint32_t seq = 0U; seq < zone_seq_lim(loc); seq++)
+				{
+					auto& z = this->zone(con, loc, seq);
+					z.card = nullptr;
+					z.materials.clear();
+				}
+			}
+		}
+	}
+
+	// Sets `p` to either of the sizes of `rsz_op`.
+	constexpr auto resize_to_(PileType& p, ResizeOp const& rsz_op,
+	                          size_t size) noexcept -> void
+	{
+		if(p.size() < size)
+		{
+			auto const slice = arena_at_(rsz_op.offset);
+			p.insert(p.end(), slice, slice + rsz_op.slice_size());
+		}
+		else if(p.size() > size)
+			p.resize(size);
+		assert(p.size() == size);
+		this->verify_pile_(p);
 	}
 
 	constexpr auto current_op_as_card_() noexcept -> Card*&
 	{
-		assert(operations_.size() >= op_);
-		assert(std::holds_alternative<CardOp>(operations_[op_ - 1]));
-		return std::get<CardOp>(operations_[op_ - 1]).card;
+		return current_op_<CardOp>().card;
+	}
+
+	template<typename T>
+	constexpr auto current_op_() noexcept -> T&
+	{
+		assert(op_ > dropped_op_);
+		return std::get<T>(op_at_(op_ - 1U));
+	}
+
+	constexpr auto op_at_(OperationCountType op) noexcept -> Ops&
+	{
+		assert(op >= dropped_op_ && op - dropped_op_ < operations_.size());
+		return operations_[op - dropped_op_];
+	}
+
+	constexpr auto arena_at_(size_t offset) const noexcept
+	{
+		assert(offset >= arena_base_);
+		return arena_.cbegin() + (offset - arena_base_);
+	}
+
+	constexpr auto run_at_(size_t offset) const noexcept
+	{
+		assert(offset >= run_base_);
+		return runs_.cbegin() + (offset - run_base_);
+	}
+
+	// Destroys every card in the arena range given.
+	constexpr auto destruct_cards_(size_t offset, size_t size) noexcept
+		-> void
+	{
+		for(auto it = arena_at_(offset); size != 0U; ++it, size--)
+		{
+			if(*it != nullptr)
+				BaseFrame::destruct_card(**it);
+		}
+	}
+
+	// Forgets the oldest operation, which must have been done. The cards it
+	// took out of the frame can no longer come back, so they are destroyed.
+	constexpr auto drop_oldest_op_() noexcept -> void
+	{
+		assert(dropped_op_ < op_);
+		auto const& op = operations_.front();
+		if(auto const* card_op = std::get_if<CardOp>(&op))
+		{
+			if(!card_op->added)
+				BaseFrame::destruct_card(*card_op->card);
+		}
+		else if(auto const* rsz_op = std::get_if<ResizeOp>(&op))
+		{
+			if(rsz_op->count < rsz_op->prev_size)
+				destruct_cards_(rsz_op->offset, rsz_op->slice_size());
+			arena_dead_ = rsz_op->offset + rsz_op->slice_size();
+		}
+		else if(auto const* clear_op = std::get_if<ClearOp>(&op))
+		{
+			auto const runs = run_at_(clear_op->run_offset);
+			size_t size = 0U;
+			for(auto it = runs; it != runs + clear_op->run_count; ++it)
+				size += it->size;
+			destruct_cards_(clear_op->card_offset, size);
+			arena_dead_ = clear_op->card_offset + size;
+			run_dead_ = clear_op->run_offset + clear_op->run_count;
+		}
+		operations_.pop_front();
+		dropped_op_++;
+		// NOTE: Only compacted when most of the elements are dead, so that
+		// forgetting operations is amortized constant time.
+		if(arena_dead_ - arena_base_ > arena_.size() / 2U)
+		{
+			arena_.erase(arena_.begin(), arena_at_(arena_dead_));
+			arena_base_ = arena_dead_;
+		}
+		if(run_dead_ - run_base_ > runs_.size() / 2U)
+		{
+			runs_.erase(runs_.begin(), run_at_(run_dead_));
+			run_base_ = run_dead_;
+		}
+	}
+
+	// Forgets all the operations from `first` on, which must be undone. The
+	// cards they made are in limbo and can no longer come back, so they are
+	// destroyed.
+	constexpr auto forget_ops_from_(OperationCountType first) noexcept -> void
+	{
+		assert(first >= op_ && first <= processed_op_);
+		if(first != processed_op_)
+			rewrites_.push_back(first);
+		auto arena_end = arena_base_ + arena_.size();
+		auto run_end = run_base_ + runs_.size();
+		for(auto i = first; i != processed_op_; i++)
+		{
+			auto const& op = op_at_(i);
+			if(auto const* card_op = std::get_if<CardOp>(&op))
+			{
+				if(card_op->added)
+					BaseFrame::destruct_card(*card_op->card);
+			}
+			else if(auto const* rsz_op = std::get_if<ResizeOp>(&op))
+			{
+				if(rsz_op->count > rsz_op->prev_size)
+					destruct_cards_(rsz_op->offset, rsz_op->slice_size());
+				arena_end = std::min<size_t>(arena_end, rsz_op->offset);
+			}
+			else if(auto const* clear_op = std::get_if<ClearOp>(&op))
+			{
+				arena_end = std::min<size_t>(arena_end, clear_op->card_offset);
+				run_end = std::min<size_t>(run_end, clear_op->run_offset);
+			}
+		}
+		operations_.resize(first - dropped_op_);
+		arena_.resize(arena_end - arena_base_);
+		runs_.resize(run_end - run_base_);
+		processed_op_ = first;
 	}
 
 	template<typename T>
 	constexpr auto emplace_op_() noexcept -> T&
 	{
+		if(operations_.size() == limit_)
+			drop_oldest_op_();
 		return std::get<T>(operations_.emplace_back(std::in_place_type_t<T>{}));
 	}
 };
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_CLIENT_PACKED_CARD_TRAITS_HPP
+#define YGOPEN_CLIENT_PACKED_CARD_TRAITS_HPP
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <ygopen/client/value_types.hpp>
+#include <ygopen/detail/small_vector.hpp>
+#include <ygopen/duel/constants_fwd.hpp>
+
+namespace YGOpen::Client
+{
+
+namespace Detail
+{
+
+template<typename T, bool = std::is_enum_v<T>>
+struct Underlying
+{
+	using type = T;
+};
+
+template<typename T>
+struct Underlying<T, true>
+{
+	using type = std::underlying_type_t<T>;
+};
+
+// Stores a `T` in the narrower `Storage`. Exposes `ValueType` so that
+// `parse_query` parses values as `T`. Values that do not fit saturate to the
+// closest one that does, rather than wrapping around.
+template<typename T, typename Storage>
+class Narrow
+{
+public:
+	using ValueType = T;
+
+	constexpr Narrow() noexcept = default;
+
+	constexpr Narrow(T value) noexcept : v_(saturate(value)) {}
+
+	constexpr operator T() const noexcept { return static_cast<T>(v_); }
+
+private:
+	static_assert(sizeof(Storage) < sizeof(int64_t));
+
+	Storage v_{};
+
+	[[nodiscard]] static constexpr auto saturate(T value) noexcept -> Storage
+	{
+		using Wide = typename Underlying<T>::type;
+		constexpr auto LOWEST = std::numeric_limits<Storage>::lowest();
+		constexpr auto HIGHEST = std::numeric_limits<Storage>::max();
+		auto const v = static_cast<Wide>(value);
+		if constexpr(std::is_signed_v<Wide>)
+		{
+			if(static_cast<int64_t>(v) < static_cast<int64_t>(LOWEST))
+				return LOWEST;
+			if(static_cast<int64_t>(v) > static_cast<int64_t>(HIGHEST))
+				return HIGHEST;
+		}
+		else if(static_cast<uint64_t>(v) > static_cast<uint64_t>(HIGHEST))
+		{
+			return HIGHEST;
+		}
+		return static_cast<Storage>(v);
+	}
+};
+
+} // namespace Detail
+
+// Same as DefaultCardTraits but with every value stored as narrow as the
+// values the core gives allow, and with places, counters and targets stored
+// as value types instead of protobuf messages. Cards usually have at most a
+// single target and a single kind of counter, so those are kept inline.
+// NOTE: Races are kept as wide as the protocol's even though the races known
+// today fit in 32 bits, so that newer races the core adds are not lost.
+struct PackedCardTraits
+{
+	using CodeType = uint32_t;
+	using PositionType = Detail::Narrow<YGOpen::Duel::Position, uint8_t>;
+	using AliasType = CodeType;
+	using TypeType = YGOpen::Duel::Type;
+	using LevelType = Detail::Narrow<int32_t, int8_t>;
+	using XyzRankType = Detail::Narrow<uint32_t, uint8_t>;
+	using AttributeType = Detail::Narrow<YGOpen::Duel::Attribute, uint8_t>;
+	using RaceType = YGOpen::Duel::Race;
+	using AtkType = int32_t;
+	using DefType = AtkType;
+	using BaseAtkType = AtkType;
+	using BaseDefType = AtkType;
+	using EquippedToType = PlaceValue;
+	using TargetsType = YGOpen::Detail::SmallVector<PlaceValue, 1U>;
+	using CountersType = YGOpen::Detail::SmallVector<CounterValue, 1U>;
+	using OwnerType = Detail::Narrow<YGOpen::Duel::Controller, int8_t>;
+	using StatusType = YGOpen::Duel::Status;
+	using IsPublicType = bool;
+	using PendLScaleType = Detail::Narrow<uint32_t, uint8_t>;
+	using PendRScaleType = PendLScaleType;
+	using IsHiddenType = bool;
+	using CoverType = CodeType;
+	using LinkRateType = Detail::Narrow<uint32_t, uint8_t>;
+	using LinkArrowType = Detail::Narrow<YGOpen::Duel::LinkArrow, uint16_t>;
+};
+
+} // namespace YGOpen::Client
+
+#endif // YGOPEN_CLIENT_PACKED_CARD_TRAITS_HPP
@@ -5,6 +5,8 @@
  */
 #ifndef YGOPEN_CLIENT_PARSE_EVENT_HPP
 #define YGOPEN_CLIENT_PARSE_EVENT_HPP
+#include <type_traits>
+#include <utility>
 #include <ygopen/detail/config.hpp>
 #include <ygopen/duel/constants/controller.hpp>
 #include <ygopen/proto/duel/msg.hpp>
@@ -34,6 +36,7 @@ concept GettableAndSettable = requires(T t, Concrete c)
 	t = c;
 };
 
+// NOTE: `cards_add` is optional, see `Detail::frame_cards_add`.
 template<typename T>
 concept Frame = requires(T f, Proto::Duel::Place const& p)
 {
@@ -76,6 +79,39 @@ concept Board = requires(T b, Duel::Controller c)
 };
 #endif
 
+namespace Detail
+{
+
+template<typename Frame, typename It, typename = void>
+struct HasCardsAdd : std::false_type
+{};
+
+template<typename Frame, typename It>
+struct HasCardsAdd<Frame, It,
+                   std::void_t<decltype(std::declval<Frame&>().cards_add(
+                       std::declval<It>(), std::declval<It>()))>>
+	: std::true_type
+{};
+
+// Adds the cards with the frame's `cards_add` if it has one, or one by one
+// otherwise, so that frames that predate it keep working.
+template<typename Frame, typename It>
+constexpr auto frame_cards_add(Frame& frame, It first, It last) noexcept
+	-> void
+{
+	if constexpr(HasCardsAdd<Frame, It>::value)
+	{
+		frame.cards_add(first, last);
+	}
+	else
+	{
+		for(; first != last; ++first)
+			frame.card_add(*first);
+	}
+}
+
+} // namespace Detail
+
 template<YGOPEN_CONCEPT(Board)>
 auto parse_event(Board& board, Proto::Duel::Msg::Event const& event) noexcept
 	-> void
@@ -97,8 +133,8 @@ auto parse_event(Board& board, Proto::Duel::Msg::Event const& event) noexcept
 				frame.pile_resize(op.place(), op.count());
 			for(auto const& place : exchange.remove().places())
 				frame.card_remove(place);
-			for(auto const& place : exchange.add().places())
-				frame.card_add(place);
+			auto const& places = exchange.add().places();
+			Detail::frame_cards_add(frame, places.cbegin(), places.cend());
 			break;
 		}
 		case Msg::Event::Board::kState:
@@ -111,8 +147,8 @@ auto parse_event(Board& board, Proto::Duel::Msg::Event const& event) noexcept
 			auto const& chains = state.chains();
 			board.chain_stack().assign(chains.cbegin(), chains.cend());
 			frame.clear();
-			for(auto const& place : state.add().places())
-				frame.card_add(place);
+			auto const& places = state.add().places();
+			Detail::frame_cards_add(frame, places.cbegin(), places.cend());
 			for(auto const& op : state.resize().ops())
 				frame.pile_resize(op.place(), op.count());
 			break;
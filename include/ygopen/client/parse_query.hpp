@@ -5,6 +5,7 @@
  */
 #ifndef YGOPEN_CLIENT_PARSE_QUERY_HPP
 #define YGOPEN_CLIENT_PARSE_QUERY_HPP
+#include <algorithm>
 #include <limits>
 #include <ygopen/proto/duel/data.hpp>
 #include <ygopen/proto/duel/msg.hpp>
@@ -74,6 +75,21 @@ struct ValueTypeSelector<T, std::void_t<typename T::ValueType>>
 template<typename T>
 using ValueTypeOrT = typename ValueTypeSelector<T>::Type;
 
+// Assigns the values of a repeated field to the card's container, unless
+// `use_cache` is set and both hold the same values already, in which case
+// nothing is done and true is returned.
+template<bool use_cache, typename Container, typename RepeatedField>
+auto assign_values(Container& c, RepeatedField const& rf) noexcept -> bool
+{
+	if constexpr(use_cache)
+	{
+		if(std::equal(c.cbegin(), c.cend(), rf.cbegin(), rf.cend()))
+			return true;
+	}
+	c.assign(rf.cbegin(), rf.cend());
+	return false;
+}
+
 } // namespace Detail
 
 template<bool use_cache = false, typename Frame>
@@ -107,17 +123,38 @@ template<bool use_cache = false, typename Frame>
 #include <ygopen/client/queries.inl>
 #undef EXPAND_SEPARATE_LINK_DATA_QUERIES
 #undef X
-	// TODO: Cache it up
-	if(data.has_counters())
-	{
-		auto const& rf = data.counters().values();
-		card.counters().assign(rf.cbegin(), rf.cend());
-	}
-	if(data.has_targets())
-	{
-		auto const& rf = data.targets().values();
-		card.targets().assign(rf.cbegin(), rf.cend());
-	}
+	if(data.has_counters() &&
+	   Detail::assign_values<use_cache>(card.counters(),
+	                                    data.counters().values()))
+		hits |= (QueryCacheHit::COUNTERS);
+	if(data.has_targets() &&
+	   Detail::assign_values<use_cache>(card.targets(),
+	                                    data.targets().values()))
+		hits |= (QueryCacheHit::TARGET_CARD);
+	return hits;
+}
+
+// Same as `parse_query<true>`, but also removes from `query` every value that
+// hit the cache. Parsing the resulting query on a frame that was in the same
+// state as `frame` yields the same result as parsing the original query would.
+template<typename Frame>
+[[nodiscard]] auto parse_query_delta(Frame& frame,
+                                     Proto::Duel::Msg::Query& query) noexcept
+	-> QueryCacheHit
+{
+	auto const hits = parse_query<true>(frame, query);
+	if(!hits)
+		return hits;
+	auto& data = *query.mutable_data();
+#define X(NAME, Name, name, value)     \
+	if(!!(hits & QueryCacheHit::NAME)) \
+		data.clear_##name();
+#define EXPAND_ARRAY_LIKE_QUERIES
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef EXPAND_ARRAY_LIKE_QUERIES
+#undef X
 	return hits;
 }
 
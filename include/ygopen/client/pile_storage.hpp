@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_CLIENT_PILE_STORAGE_HPP
+#define YGOPEN_CLIENT_PILE_STORAGE_HPP
+#include <cstddef>
+#include <vector>
+#include <ygopen/detail/small_vector.hpp>
+
+// Policies used by BasicFrame to pick the containers of card pointers it uses
+// for piles and for zone materials. Interface:
+//  PileType: Sequence container of `Card*` used by piles.
+//  MaterialsType: Sequence container of `Card*` used by zone materials.
+
+namespace YGOpen::Client
+{
+
+namespace Detail
+{
+
+enum DeckLimit : size_t
+{
+	DECK_LIMIT_MAIN = 60U,
+	DECK_LIMIT_EXTRA = 15U,
+};
+
+} // namespace Detail
+
+// Every pile and material list allocates on its own.
+template<typename Card>
+struct VectorPileStorage
+{
+	using PileType = std::vector<Card*>;
+	using MaterialsType = std::vector<Card*>;
+};
+
+// Piles and material lists keep their first cards inline, only allocating if
+// they ever grow past their capacity. The default pile capacity holds all the
+// cards a player's decks can have, so piles of regular duels never allocate.
+template<typename Card,
+         size_t PileCapacity = Detail::DECK_LIMIT_MAIN +
+                               Detail::DECK_LIMIT_EXTRA,
+         size_t MaterialsCapacity = 8U>
+struct InlinePileStorage
+{
+	using PileType = YGOpen::Detail::SmallVector<Card*, PileCapacity>;
+	using MaterialsType = YGOpen::Detail::SmallVector<Card*, MaterialsCapacity>;
+};
+
+} // namespace YGOpen::Client
+
+#endif // YGOPEN_CLIENT_PILE_STORAGE_HPP
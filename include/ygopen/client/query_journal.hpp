@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_CLIENT_QUERY_JOURNAL_HPP
+#define YGOPEN_CLIENT_QUERY_JOURNAL_HPP
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <ygopen/client/parse_query.hpp>
+#include <ygopen/proto/duel/msg.hpp>
+
+namespace YGOpen::Client
+{
+
+// Undo record of the card values changed by parsed queries, so cards do not
+// need each of their values to be a BasicUndoable. Queries are parsed in
+// steps (usually all the queries of a message), and only the values that
+// actually change are recorded, as the card they belong to, which value it
+// is, and the value it had. Undoing or redoing a step is a single walk over
+// its records, swapping each value with its recorded counterpart.
+//
+// NOTE: Recorded cards must outlive their records, which is the case for
+// cards of a LimboFrame as long as its history is not forgotten.
+template<typename Card>
+class BasicQueryJournal
+{
+public:
+	using CardType = Card;
+
+	// Identifies each of the values of a card.
+	enum class Field : uint8_t
+	{
+#define X(NAME, Name, name, value) NAME,
+#define EXPAND_ARRAY_LIKE_QUERIES
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef EXPAND_ARRAY_LIKE_QUERIES
+#undef X
+	};
+
+	explicit BasicQueryJournal() noexcept = default;
+
+	// Amount of steps done.
+	[[nodiscard]] auto position() const noexcept -> size_t { return step_; }
+
+	// Amount of steps recorded, undone ones included.
+	[[nodiscard]] auto size() const noexcept -> size_t { return steps_.size(); }
+
+	// Amount of values recorded.
+	[[nodiscard]] auto history_size() const noexcept -> size_t
+	{
+		return records_.size();
+	}
+
+	// Parses `query` as a step of its own. Same as `parse_query<true>`.
+	template<typename Frame>
+	auto parse(Frame& frame, Proto::Duel::Msg::Query const& query) noexcept
+		-> QueryCacheHit
+	{
+		begin_step_();
+		return parse_(frame, query);
+	}
+
+	// Parses all `queries` as a single step.
+	template<typename Frame, typename Queries>
+	auto parse(Frame& frame, Queries const& queries) noexcept -> void
+	{
+		begin_step_();
+		for(auto const& query : queries)
+			static_cast<void>(parse_(frame, query));
+	}
+
+	// Puts back the values changed by the last step done.
+	auto undo() noexcept -> void
+	{
+		assert(step_ != 0U);
+		step_--;
+		auto const first = records_.cbegin() + steps_[step_];
+		for(auto it = records_.cbegin() + step_end_(step_); it != first;)
+			swap_(*--it);
+	}
+
+	// Changes again the values put back by the last step undone.
+	auto redo() noexcept -> void
+	{
+		assert(step_ < steps_.size());
+		auto const last = records_.cbegin() + step_end_(step_);
+		for(auto it = records_.cbegin() + steps_[step_]; it != last; ++it)
+			swap_(*it);
+		step_++;
+	}
+
+	// Forget steps that were undone. If at the last step then this is a no-op.
+	auto erase_history() noexcept -> void
+	{
+		if(step_ == steps_.size())
+			return;
+		auto const first = steps_[step_];
+		while(records_.size() != first)
+		{
+			pop_(records_.back());
+			records_.pop_back();
+		}
+		steps_.resize(step_);
+	}
+
+private:
+	struct Record
+	{
+		Card* card;
+		uint32_t index; // Of the value in the column of its field.
+		Field field;
+	};
+
+	size_t step_{};
+	std::vector<size_t> steps_; // First record of each step.
+	std::vector<Record> records_;
+#define X(NAME, Name, name, value) \
+	std::vector<typename Card::Name##Type> name##_;
+#define EXPAND_ARRAY_LIKE_QUERIES
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef EXPAND_ARRAY_LIKE_QUERIES
+#undef X
+
+	auto begin_step_() noexcept -> void
+	{
+		erase_history();
+		steps_.push_back(records_.size());
+		step_++;
+	}
+
+	auto step_end_(size_t step) const noexcept -> size_t
+	{
+		return (step + 1U == steps_.size()) ? records_.size()
+		                                    : steps_[step + 1U];
+	}
+
+	template<typename Values>
+	auto record_(Card& card, Field field, Values& values) noexcept -> void
+	{
+		assert(values.size() <= UINT32_MAX);
+		auto const index = static_cast<uint32_t>(values.size());
+		records_.push_back({&card, index, field});
+	}
+
+	template<typename Frame>
+	auto parse_(Frame& frame, Proto::Duel::Msg::Query const& query) noexcept
+		-> QueryCacheHit
+	{
+		auto const& data = query.data();
+		auto& card = frame.card(query.place());
+		// NOTE: Same comparisons `parse_query<true>` does.
+#define X(NAME, Name, name, value_)                                        \
+	if(data.has_##name())                                                  \
+	{                                                                      \
+		using ValueType = Detail::ValueTypeOrT<typename Card::Name##Type>; \
+		if(!(card.name() == ValueType{data.name().value()}))               \
+		{                                                                  \
+			record_(card, Field::NAME, name##_);                           \
+			name##_.push_back(card.name());                                \
+		}                                                                  \
+	}
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef X
+		auto record_values = [&](Field field, auto& values, auto const& c,
+		                         auto const& rf)
+		{
+			if(std::equal(c.cbegin(), c.cend(), rf.cbegin(), rf.cend()))
+				return;
+			record_(card, field, values);
+			values.push_back(c);
+		};
+		if(data.has_counters())
+			record_values(Field::COUNTERS, counters_, card.counters(),
+			              data.counters().values());
+		if(data.has_targets())
+			record_values(Field::TARGET_CARD, targets_, card.targets(),
+			              data.targets().values());
+		return parse_query<true>(frame, query);
+	}
+
+	auto swap_(Record const& r) noexcept -> void
+	{
+		using std::swap;
+		switch(r.field)
+		{
+#define X(NAME, Name, name, value)              \
+	case Field::NAME:                           \
+		swap(r.card->name(), name##_[r.index]); \
+		break;
+#define EXPAND_ARRAY_LIKE_QUERIES
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef EXPAND_ARRAY_LIKE_QUERIES
+#undef X
+		}
+	}
+
+	auto pop_(Record const& r) noexcept -> void
+	{
+		switch(r.field)
+		{
+#define X(NAME, Name, name, value)              \
+	case Field::NAME:                           \
+		assert(r.index + 1U == name##_.size()); \
+		name##_.pop_back();                     \
+		break;
+#define EXPAND_ARRAY_LIKE_QUERIES
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef EXPAND_ARRAY_LIKE_QUERIES
+#undef X
+		}
+	}
+};
+
+} // namespace YGOpen::Client
+
+#endif // YGOPEN_CLIENT_QUERY_JOURNAL_HPP
@@ -0,0 +1,553 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_CLIENT_SNAPSHOT_HPP
+#define YGOPEN_CLIENT_SNAPSHOT_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <ygopen/client/frame.hpp>
+#include <ygopen/client/parse_query.hpp>
+#include <ygopen/client/state_hash.hpp>
+#include <ygopen/client/value_types.hpp>
+#include <ygopen/duel/constants/controller.hpp>
+#include <ygopen/duel/constants/location.hpp>
+#include <ygopen/proto/duel/data.hpp>
+#include <ygopen/proto/duel/msg.hpp>
+
+// Flat binary snapshots of a BasicBoard (or of a BasicFrame alone), for
+// persisting a duel and bringing it back without replaying its messages nor
+// parsing protobuf: hot-restarting servers, replay keyframes, handing a duel
+// over to another process...
+//
+// A snapshot is a header followed by arrays of fixed-size records, each
+// section starting 8-byte aligned, so a snapshot can be written to a file as
+// is and later restored straight from a mapping of it:
+//
+//   SnapshotHeader
+//   uint32_t counts[SNAPSHOT_SLOT_COUNT] (cards per zone, materials and pile)
+//   SnapshotCard cards[card_count] (in the order of `for_each_card`)
+//   uint64_t targets[target_count] (as `PlaceValue::key`)
+//   SnapshotCounter counters[counter_count]
+//   SnapshotChain chains[chain_count]
+//   uint64_t blocked_zones[blocked_zone_count] (as `PlaceValue::key`)
+//
+// NOTE: Values are in host byte order, snapshots from hosts with a different
+// byte order are rejected as having a bad magic.
+
+namespace YGOpen::Client
+{
+
+namespace Detail
+{
+
+inline constexpr uint32_t SNAPSHOT_MAGIC = 0x534E5059U; // "YPNS"
+// NOTE: Bump when changing any record below (or queries.inl).
+inline constexpr uint16_t SNAPSHOT_VERSION = 1U;
+
+// Zone cards, then materials, then piles, of both controllers.
+inline constexpr size_t SNAPSHOT_SLOT_COUNT =
+	Duel::CONTROLLER_ARRAY_SIZE *
+	(ZONE_COUNT + ZONE_COUNT + PILE_LOCATIONS.size());
+
+struct SnapshotHeader
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t reserved;
+	uint64_t size; // Of the whole snapshot, header included.
+	uint32_t card_count;
+	uint32_t target_count;
+	uint32_t counter_count;
+	uint32_t chain_count;
+	uint32_t blocked_zone_count;
+	uint32_t turn;
+	int32_t turn_controller;
+	uint32_t phase;
+	std::array<uint32_t, Duel::CONTROLLER_ARRAY_SIZE> lp;
+};
+
+static_assert(sizeof(SnapshotHeader) == 56U);
+
+// The type a query value has in duel_msg.proto, places are stored as keys.
+template<typename T>
+using SnapshotFieldT = std::conditional_t<std::is_arithmetic_v<T>, T, uint64_t>;
+
+using SnapshotQueryData = Proto::Duel::Msg::Query::Data;
+
+struct SnapshotCard
+{
+#define X(NAME, Name, name, value_)                                 \
+	SnapshotFieldT<std::decay_t<decltype(                           \
+		std::declval<SnapshotQueryData const&>().name().value())>> \
+		name;
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef X
+	uint32_t target_count;
+	uint32_t counter_count;
+};
+
+static_assert(std::is_trivially_copyable_v<SnapshotCard>);
+static_assert(sizeof(SnapshotCard) % alignof(uint64_t) == 0U);
+
+struct SnapshotCounter
+{
+	uint32_t type;
+	uint32_t count;
+};
+
+struct SnapshotChain
+{
+	uint64_t card_place;
+	uint64_t place;
+	uint32_t code;
+	uint32_t index;
+};
+
+template<typename T, typename = void>
+struct HasFrame : std::false_type
+{};
+
+template<typename T>
+struct HasFrame<T, std::void_t<decltype(std::declval<T&>().frame())>>
+	: std::true_type
+{};
+
+template<typename T, typename = void>
+struct HasRehash : std::false_type
+{};
+
+template<typename T>
+struct HasRehash<T, std::void_t<decltype(std::declval<T&>().rehash())>>
+	: std::true_type
+{};
+
+template<typename Place>
+[[nodiscard]] constexpr auto place_key(Place const& p) noexcept -> uint64_t
+{
+	return PlaceValue{p.con(), p.loc(), p.seq(), p.oseq()}.key();
+}
+
+template<typename Place>
+constexpr auto set_place_key(Place& p, uint64_t key) noexcept -> void
+{
+	auto const v = PlaceValue::from_key(key);
+	p.set_con(v.con());
+	p.set_loc(v.loc());
+	p.set_seq(v.seq());
+	p.set_oseq(v.oseq());
+}
+
+// Value (unwrapped from BasicUndoable, Narrow, ...) of `v` as stored in a
+// snapshot.
+template<typename F, typename T>
+[[nodiscard]] constexpr auto to_snapshot_field(T const& v) noexcept -> F
+{
+	auto const value = static_cast<ValueTypeOrT<T>>(v);
+	if constexpr(IsPlaceLike<ValueTypeOrT<T>>::value)
+		return place_key(value);
+	else
+		return static_cast<F>(value);
+}
+
+template<typename T, typename F>
+[[nodiscard]] constexpr auto from_snapshot_field(F f) noexcept
+	-> ValueTypeOrT<T>
+{
+	using V = ValueTypeOrT<T>;
+	if constexpr(IsPlaceLike<V>::value)
+	{
+		V v;
+		set_place_key(v, f);
+		return v;
+	}
+	else
+	{
+		return static_cast<V>(f);
+	}
+}
+
+// Slot of the `counts` section a card is counted in.
+template<typename Place>
+[[nodiscard]] constexpr auto snapshot_slot(Place const& place) noexcept
+	-> size_t
+{
+	constexpr size_t MATERIALS = Duel::CONTROLLER_ARRAY_SIZE * ZONE_COUNT;
+	constexpr size_t PILES = MATERIALS * 2U;
+	auto const con = static_cast<size_t>(place.con());
+	if(is_pile(place))
+	{
+		return PILES + con * PILE_LOCATIONS.size() +
+		       loc_index(get_loc(place));
+	}
+	auto const i = con * ZONE_COUNT + zone_index(get_loc(place), place.seq());
+	return (place.oseq() < 0) ? i : MATERIALS + i;
+}
+
+template<typename T>
+auto snapshot_append(std::vector<std::byte>& out, T const* data,
+                     size_t count) noexcept -> void
+{
+	auto const* first = reinterpret_cast<std::byte const*>(data);
+	out.insert(out.end(), first, first + count * sizeof(T));
+}
+
+template<typename T>
+[[nodiscard]] auto snapshot_read(std::byte const* data) noexcept -> T
+{
+	T v;
+	std::memcpy(&v, data, sizeof(T));
+	return v;
+}
+
+template<typename Frame>
+auto snapshot_restore_cards(Frame& frame, std::byte const* counts,
+                            std::byte const* cards,
+                            std::byte const* targets,
+                            std::byte const* counters) noexcept -> void
+{
+	using namespace YGOpen::Duel;
+	using CardType = typename Frame::CardType;
+	using TargetT =
+		typename std::decay_t<decltype(value_of(
+			std::declval<CardType const&>().targets()))>::value_type;
+	using CounterT =
+		typename std::decay_t<decltype(value_of(
+			std::declval<CardType const&>().counters()))>::value_type;
+	constexpr auto OSEQ_NONE = Proto::Duel::OSEQ_INVALID;
+	std::vector<TargetT> card_targets;
+	std::vector<CounterT> card_counters;
+	auto fill = [&](CardType& card) noexcept
+	{
+		auto const r = snapshot_read<SnapshotCard>(cards);
+		cards += sizeof(SnapshotCard);
+#define X(NAME, Name, name, value) \
+	card.name() = from_snapshot_field<typename CardType::Name##Type>(r.name);
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef X
+		if(r.target_count != 0U)
+		{
+			card_targets.resize(r.target_count);
+			for(auto& t : card_targets)
+			{
+				set_place_key(t, snapshot_read<uint64_t>(targets));
+				targets += sizeof(uint64_t);
+			}
+			card.targets().assign(card_targets.cbegin(), card_targets.cend());
+		}
+		if(r.counter_count != 0U)
+		{
+			card_counters.resize(r.counter_count);
+			for(auto& c : card_counters)
+			{
+				auto const sc = snapshot_read<SnapshotCounter>(counters);
+				counters += sizeof(SnapshotCounter);
+				c.set_type(sc.type);
+				c.set_count(sc.count);
+			}
+			card.counters().assign(card_counters.cbegin(),
+			                       card_counters.cend());
+		}
+	};
+	auto next_count = [&counts]() noexcept
+	{
+		auto const count = snapshot_read<uint32_t>(counts);
+		counts += sizeof(uint32_t);
+		return count;
+	};
+	for(auto con : {CONTROLLER_0, CONTROLLER_1})
+	{
+		for(auto loc : ZONE_LOCATIONS)
+		{
+			for(uint32_t seq = 0U; seq < zone_seq_lim(loc); seq++)
+			{
+				if(next_count() != 0U)
+					fill(frame.card_add(PlaceValue{con, loc, seq, OSEQ_NONE}));
+			}
+		}
+	}
+	for(auto con : {CONTROLLER_0, CONTROLLER_1})
+	{
+		for(auto loc : ZONE_LOCATIONS)
+		{
+			for(uint32_t seq = 0U; seq < zone_seq_lim(loc); seq++)
+			{
+				auto const count = static_cast<int32_t>(next_count());
+				for(int32_t oseq = 0; oseq < count; oseq++)
+					fill(frame.card_add(PlaceValue{con, loc, seq, oseq}));
+			}
+		}
+	}
+	for(auto con : {CONTROLLER_0, CONTROLLER_1})
+	{
+		for(auto loc : PILE_LOCATIONS)
+		{
+			PlaceValue const place{con, loc, 0U, OSEQ_NONE};
+			frame.pile_resize(place, next_count());
+			for(auto* c : frame.pile(place))
+				fill(*c);
+		}
+	}
+}
+
+} // namespace Detail
+
+struct RestoreSnapshotResult
+{
+	enum class State
+	{
+		// Board now holds the snapshot's state.
+		OK,
+		// Not a snapshot, or one taken on a host with another byte order.
+		// Board is left untouched.
+		BAD_MAGIC,
+		// Snapshot of another version of the format.
+		// Board is left untouched.
+		BAD_VERSION,
+		// Snapshot is bigger than the buffer given.
+		// Board is left untouched.
+		TRUNCATED,
+		// Sections do not add up, cards are where they cannot be or there are
+		// more of them in a place than places can address.
+		// Board is left untouched.
+		CORRUPTED,
+	} state;
+	// Size of the snapshot read, 0 unless `state` is OK.
+	size_t bytes_read;
+};
+
+// Writes every card of `b` (a BasicBoard or a BasicFrame), their values and,
+// for boards, every other board value in a new snapshot.
+template<typename BoardOrFrame>
+[[nodiscard]] auto take_snapshot(BoardOrFrame const& b) noexcept
+	-> std::vector<std::byte>
+{
+	using namespace Detail;
+	SnapshotHeader header{};
+	header.magic = SNAPSHOT_MAGIC;
+	header.version = SNAPSHOT_VERSION;
+	std::array<uint32_t, SNAPSHOT_SLOT_COUNT> counts{};
+	std::vector<SnapshotCard> cards;
+	std::vector<uint64_t> targets;
+	std::vector<SnapshotCounter> counters;
+	std::vector<SnapshotChain> chains;
+	std::vector<uint64_t> blocked_zones;
+	auto add = [&](PlaceValue const& place, auto const& card)
+	{
+		counts[snapshot_slot(place)]++;
+		SnapshotCard r;
+		// NOTE: Padding is zeroed too, so equal states give equal bytes.
+		std::memset(&r, 0, sizeof(r));
+#define X(NAME, Name, name, value) \
+	r.name = to_snapshot_field<decltype(r.name)>(card.name());
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef X
+		auto const& card_targets = value_of(card.targets());
+		for(auto it = card_targets.cbegin(); it != card_targets.cend(); ++it)
+		{
+			targets.push_back(place_key(*it));
+			r.target_count++;
+		}
+		auto const& card_counters = value_of(card.counters());
+		for(auto it = card_counters.cbegin(); it != card_counters.cend(); ++it)
+		{
+			counters.push_back({it->type(), it->count()});
+			r.counter_count++;
+		}
+		cards.push_back(r);
+	};
+	if constexpr(HasFrame<BoardOrFrame>::value)
+	{
+		for_each_card(b.frame(), add);
+		header.turn = to_snapshot_field<uint32_t>(b.turn());
+		header.turn_controller =
+			to_snapshot_field<int32_t>(b.turn_controller());
+		header.phase = to_snapshot_field<uint32_t>(b.phase());
+		for(auto con : {Duel::CONTROLLER_0, Duel::CONTROLLER_1})
+			header.lp[con] = to_snapshot_field<uint32_t>(b.lp(con));
+		auto const& chain_stack = value_of(b.chain_stack());
+		for(auto it = chain_stack.cbegin(); it != chain_stack.cend(); ++it)
+		{
+			chains.push_back({place_key(it->card_place()),
+			                  place_key(it->place()), it->effect().code(),
+			                  it->effect().index()});
+		}
+		auto const& zones = value_of(b.blocked_zones());
+		for(auto it = zones.cbegin(); it != zones.cend(); ++it)
+			blocked_zones.push_back(place_key(*it));
+	}
+	else
+	{
+		for_each_card(b, add);
+	}
+	header.card_count = static_cast<uint32_t>(cards.size());
+	header.target_count = static_cast<uint32_t>(targets.size());
+	header.counter_count = static_cast<uint32_t>(counters.size());
+	header.chain_count = static_cast<uint32_t>(chains.size());
+	header.blocked_zone_count = static_cast<uint32_t>(blocked_zones.size());
+	header.size = sizeof(header) + sizeof(counts) +
+	              cards.size() * sizeof(SnapshotCard) +
+	              targets.size() * sizeof(uint64_t) +
+	              counters.size() * sizeof(SnapshotCounter) +
+	              chains.size() * sizeof(SnapshotChain) +
+	              blocked_zones.size() * sizeof(uint64_t);
+	std::vector<std::byte> out;
+	out.reserve(header.size);
+	snapshot_append(out, &header, 1U);
+	snapshot_append(out, counts.data(), counts.size());
+	snapshot_append(out, cards.data(), cards.size());
+	snapshot_append(out, targets.data(), targets.size());
+	snapshot_append(out, counters.data(), counters.size());
+	snapshot_append(out, chains.data(), chains.size());
+	snapshot_append(out, blocked_zones.data(), blocked_zones.size());
+	return out;
+}
+
+// Replaces the state of `b` (a BasicBoard or a BasicFrame) with the one of
+// the snapshot at `data`, which needs no particular alignment. The snapshot is
+// checked in full before `b` is touched, see RestoreSnapshotResult.
+//
+// NOTE: Values are assigned as a whole, so boards using BasicUndoable get a
+// new entry in their histories instead of losing them.
+template<typename BoardOrFrame>
+[[nodiscard]] auto restore_snapshot(BoardOrFrame& b, void const* data,
+                                    size_t size) noexcept
+	-> RestoreSnapshotResult
+{
+	using namespace Detail;
+	using State = RestoreSnapshotResult::State;
+	auto const* const base = static_cast<std::byte const*>(data);
+	if(size < sizeof(SnapshotHeader))
+		return {State::TRUNCATED, 0U};
+	auto const header = snapshot_read<SnapshotHeader>(base);
+	if(header.magic != SNAPSHOT_MAGIC)
+		return {State::BAD_MAGIC, 0U};
+	if(header.version != SNAPSHOT_VERSION)
+		return {State::BAD_VERSION, 0U};
+	if(header.size > size)
+		return {State::TRUNCATED, 0U};
+	// NOTE: Counts are 32-bit, so none of these overflow.
+	uint64_t const expected_size =
+		sizeof(SnapshotHeader) + SNAPSHOT_SLOT_COUNT * sizeof(uint32_t) +
+		uint64_t{header.card_count} * sizeof(SnapshotCard) +
+		uint64_t{header.target_count} * sizeof(uint64_t) +
+		uint64_t{header.counter_count} * sizeof(SnapshotCounter) +
+		uint64_t{header.chain_count} * sizeof(SnapshotChain) +
+		uint64_t{header.blocked_zone_count} * sizeof(uint64_t);
+	if(expected_size != header.size || header.reserved != 0U)
+		return {State::CORRUPTED, 0U};
+	auto const* const counts = base + sizeof(SnapshotHeader);
+	auto const* const cards = counts + SNAPSHOT_SLOT_COUNT * sizeof(uint32_t);
+	auto const* const targets =
+		cards + size_t{header.card_count} * sizeof(SnapshotCard);
+	auto const* const counters =
+		targets + size_t{header.target_count} * sizeof(uint64_t);
+	auto const* chains =
+		counters + size_t{header.counter_count} * sizeof(SnapshotCounter);
+	auto const* blocked_zones =
+		chains + size_t{header.chain_count} * sizeof(SnapshotChain);
+	{
+		constexpr size_t ZONE_SLOTS = Duel::CONTROLLER_ARRAY_SIZE * ZONE_COUNT;
+		// NOTE: Beyond these, places (see PlaceValue) could not tell cards
+		// apart: materials are numbered by `oseq` and pile cards by `seq`.
+		constexpr uint32_t MATERIALS_LIM =
+			uint32_t{std::numeric_limits<int16_t>::max()} + 1U;
+		constexpr uint32_t PILE_LIM =
+			uint32_t{std::numeric_limits<uint16_t>::max()} + 1U;
+		uint64_t card_count = 0U;
+		for(size_t i = 0U; i < SNAPSHOT_SLOT_COUNT; i++)
+		{
+			auto const count =
+				snapshot_read<uint32_t>(counts + i * sizeof(uint32_t));
+			// NOTE: Zones hold a single card, and materials need one.
+			if(i < ZONE_SLOTS && count > 1U)
+				return {State::CORRUPTED, 0U};
+			if(i >= ZONE_SLOTS && i < ZONE_SLOTS * 2U && count != 0U &&
+			   snapshot_read<uint32_t>(counts + (i - ZONE_SLOTS) *
+			                                        sizeof(uint32_t)) == 0U)
+				return {State::CORRUPTED, 0U};
+			if(count > (i < ZONE_SLOTS * 2U ? MATERIALS_LIM : PILE_LIM))
+				return {State::CORRUPTED, 0U};
+			card_count += count;
+		}
+		uint64_t target_count = 0U;
+		uint64_t counter_count = 0U;
+		for(uint32_t i = 0U; i < header.card_count; i++)
+		{
+			auto const r = snapshot_read<SnapshotCard>(
+				cards + size_t{i} * sizeof(SnapshotCard));
+			target_count += r.target_count;
+			counter_count += r.counter_count;
+		}
+		if(card_count != header.card_count ||
+		   target_count != header.target_count ||
+		   counter_count != header.counter_count)
+			return {State::CORRUPTED, 0U};
+	}
+	if constexpr(HasFrame<BoardOrFrame>::value)
+	{
+		auto& frame = b.frame();
+		frame.clear();
+		snapshot_restore_cards(frame, counts, cards, targets, counters);
+		if constexpr(HasRehash<std::decay_t<decltype(frame)>>::value)
+			frame.rehash();
+		using TurnT = ValueTypeOrT<typename BoardOrFrame::TurnType>;
+		using TurnControllerT =
+			ValueTypeOrT<typename BoardOrFrame::TurnControllerType>;
+		using PhaseT = ValueTypeOrT<typename BoardOrFrame::PhaseType>;
+		using LPT = ValueTypeOrT<typename BoardOrFrame::LPType>;
+		b.turn() = static_cast<TurnT>(header.turn);
+		b.turn_controller() =
+			static_cast<TurnControllerT>(header.turn_controller);
+		b.phase() = static_cast<PhaseT>(header.phase);
+		for(auto con : {Duel::CONTROLLER_0, Duel::CONTROLLER_1})
+			b.lp(con) = static_cast<LPT>(header.lp[con]);
+		using ChainT = typename std::decay_t<decltype(value_of(
+			b.chain_stack()))>::value_type;
+		std::vector<ChainT> chain_stack(header.chain_count);
+		for(auto& chain : chain_stack)
+		{
+			auto const sc = snapshot_read<SnapshotChain>(chains);
+			chains += sizeof(SnapshotChain);
+			set_place_key(*chain.mutable_card_place(), sc.card_place);
+			set_place_key(*chain.mutable_place(), sc.place);
+			chain.mutable_effect()->set_code(sc.code);
+			chain.mutable_effect()->set_index(sc.index);
+		}
+		b.chain_stack().assign(chain_stack.cbegin(), chain_stack.cend());
+		using ZoneT = typename std::decay_t<decltype(value_of(
+			b.blocked_zones()))>::value_type;
+		std::vector<ZoneT> zones(header.blocked_zone_count);
+		for(auto& zone : zones)
+		{
+			set_place_key(zone, snapshot_read<uint64_t>(blocked_zones));
+			blocked_zones += sizeof(uint64_t);
+		}
+		b.blocked_zones().assign(zones.cbegin(), zones.cend());
+	}
+	else
+	{
+		b.clear();
+		snapshot_restore_cards(b, counts, cards, targets, counters);
+		if constexpr(HasRehash<BoardOrFrame>::value)
+			b.rehash();
+	}
+	return {State::OK, static_cast<size_t>(header.size)};
+}
+
+} // namespace YGOpen::Client
+
+#endif // YGOPEN_CLIENT_SNAPSHOT_HPP
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_CLIENT_STATE_HASH_HPP
+#define YGOPEN_CLIENT_STATE_HASH_HPP
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// Building blocks for hashing the state of a duel. Hashes only depend on the
+// values hashed, never on addresses nor on the types storing them, so the
+// same state hashes the same across processes and across card traits (for
+// instance, DefaultCardTraits and PackedCardTraits).
+
+namespace YGOpen::Client
+{
+
+namespace Detail
+{
+
+// Finalizer of SplitMix64, every bit of `x` affects every bit of the result.
+[[nodiscard]] constexpr auto hash_mix(uint64_t x) noexcept -> uint64_t
+{
+	x ^= x >> 30U;
+	x *= 0xBF58476D1CE4E5B9U;
+	x ^= x >> 27U;
+	x *= 0x94D049BB133111EBU;
+	x ^= x >> 31U;
+	return x;
+}
+
+[[nodiscard]] constexpr auto hash_combine(uint64_t seed, uint64_t v) noexcept
+	-> uint64_t
+{
+	return hash_mix(seed + 0x9E3779B97F4A7C15U + hash_mix(v));
+}
+
+template<typename T, typename = void>
+struct HasValueType : std::false_type
+{};
+
+template<typename T>
+struct HasValueType<T, std::void_t<typename T::ValueType>> : std::true_type
+{};
+
+// Unwraps BasicUndoable (and similar) values, anything else is given back.
+template<typename T>
+[[nodiscard]] constexpr auto value_of(T const& v) noexcept -> auto const&
+{
+	if constexpr(HasValueType<T>::value)
+		return static_cast<typename T::ValueType const&>(v);
+	else
+		return v;
+}
+
+#define YGOPEN_HASH_DETECT(Name, ...)                        \
+	template<typename T, typename = void>                    \
+	struct Name : std::false_type                            \
+	{};                                                      \
+	template<typename T>                                     \
+	struct Name<T, std::void_t<decltype(__VA_ARGS__)>>       \
+		: std::true_type                                     \
+	{};
+YGOPEN_HASH_DETECT(IsPlaceLike, std::declval<T const&>().oseq())
+YGOPEN_HASH_DETECT(IsChainLike, std::declval<T const&>().card_place())
+YGOPEN_HASH_DETECT(IsCounterLike, std::declval<T const&>().count(),
+                   std::declval<T const&>().type())
+YGOPEN_HASH_DETECT(IsEffectLike, std::declval<T const&>().code(),
+                   std::declval<T const&>().index())
+YGOPEN_HASH_DETECT(IsRangeLike, std::declval<T const&>().cbegin(),
+                   std::declval<T const&>().cend())
+#undef YGOPEN_HASH_DETECT
+
+// Hashes integers, enums, the duel_data.proto messages (or their mirrors in
+// value_types.hpp) and containers of them. Types with a `ValueType` (such as
+// BasicUndoable or narrowed values) are hashed as their `ValueType`.
+template<typename T>
+[[nodiscard]] constexpr auto hash_value(T const& v) noexcept -> uint64_t
+{
+	if constexpr(std::is_integral_v<T> || std::is_enum_v<T>)
+	{
+		return static_cast<uint64_t>(v);
+	}
+	else if constexpr(HasValueType<T>::value)
+	{
+		return hash_value(static_cast<typename T::ValueType const&>(v));
+	}
+	else if constexpr(IsPlaceLike<T>::value)
+	{
+		uint64_t h = hash_mix(static_cast<uint64_t>(v.con()));
+		h = hash_combine(h, v.loc());
+		h = hash_combine(h, v.seq());
+		return hash_combine(h, static_cast<uint64_t>(v.oseq()));
+	}
+	else if constexpr(IsChainLike<T>::value)
+	{
+		uint64_t h = hash_value(v.card_place());
+		h = hash_combine(h, hash_value(v.place()));
+		return hash_combine(h, hash_value(v.effect()));
+	}
+	else if constexpr(IsCounterLike<T>::value)
+	{
+		return hash_combine(hash_mix(v.type()), v.count());
+	}
+	else if constexpr(IsEffectLike<T>::value)
+	{
+		return hash_combine(hash_mix(v.code()), v.index());
+	}
+	else
+	{
+		static_assert(IsRangeLike<T>::value, "Type cannot be hashed");
+		uint64_t h = 0U;
+		for(auto it = v.cbegin(); it != v.cend(); ++it)
+			h = hash_combine(h, hash_value(*it));
+		return h;
+	}
+}
+
+} // namespace Detail
+
+// Hashes every value a card has.
+struct CardValuesHasher
+{
+	template<typename Card>
+	[[nodiscard]] constexpr auto operator()(Card const& card) const noexcept
+		-> uint64_t
+	{
+		uint64_t h = 0U;
+#define X(NAME, Name, name, value) \
+	h = Detail::hash_combine(h, Detail::hash_value(card.name()));
+#define EXPAND_ARRAY_LIKE_QUERIES
+#define EXPAND_SEPARATE_LINK_DATA_QUERIES
+#include <ygopen/client/queries.inl>
+#undef EXPAND_SEPARATE_LINK_DATA_QUERIES
+#undef EXPAND_ARRAY_LIKE_QUERIES
+#undef X
+		// NOTE: Always odd so that sums of equal card hashes (see HashedFrame)
+		// never wrap back to zero, which stands for "no cards".
+		return h | 1U;
+	}
+};
+
+} // namespace YGOpen::Client
+
+#endif // YGOPEN_CLIENT_STATE_HASH_HPP
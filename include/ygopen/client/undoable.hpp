@@ -5,53 +5,119 @@
  */
 #ifndef YGOPEN_CLIENT_UNDOABLE_HPP
 #define YGOPEN_CLIENT_UNDOABLE_HPP
-#include <list>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 namespace YGOpen::Client
 {
 
 // Abstraction over a regular value that keeps a record of added ones and is
 // able to go back to them for inspection.
-template<typename T, typename Container = std::list<T>>
+//
+// Values are kept in a ring buffer, holding at most `history_limit()` of them;
+// once full, adding a value forgets the oldest one.
+template<typename T>
 class BasicUndoable
 {
 public:
 	using ValueType = T;
-	using ContainerType = Container;
-
-	explicit constexpr BasicUndoable() noexcept
-		: values_(1U), current_(values_.cbegin())
-	{}
+	// Identifies one of the values ever added, counting from the first one.
+	// Stays valid for as long as the value is held.
+	using PositionType = size_t;
+
+	static constexpr size_t UNLIMITED_HISTORY = SIZE_MAX;
+
+	explicit constexpr BasicUndoable(
+		size_t history_limit = UNLIMITED_HISTORY) noexcept
+		: values_(1U)
+		, limit_(history_limit)
+		, head_(0U)
+		, count_(1U)
+		, current_(0U)
+		, base_(0U)
+	{
+		assert(limit_ > 0U);
+	}
 
 	[[nodiscard]] constexpr operator ValueType const&() const noexcept
 	{
-		return *current_;
+		return at_(current_);
 	}
 
 	template<typename U = ValueType>
 	constexpr auto operator=(U&& v) noexcept -> BasicUndoable&
 	{
-		if(current_ == --values_.cend())
-			values_.emplace_back(std::forward<U>(v));
-		current_++;
+		if(current_ == count_ - 1U)
+			next_slot_() = std::forward<U>(v);
+		else
+			current_++;
 		return *this;
 	}
 
 	template<typename U = ValueType>
 	constexpr auto operator==(U&& v) const noexcept -> bool
 	{
-		return *current_ == v;
+		return at_(current_) == v;
 	}
 
 	constexpr auto undo() noexcept -> void
 	{
-		assert(current_ != values_.cbegin());
+		assert(current_ != 0U);
 		current_--;
 	}
 
+	// Forget values that were undone. If at the last value then this is a
+	// no-op.
 	constexpr auto erase_history() noexcept -> void
 	{
-		assert(false); // TODO
+		while(count_ != current_ + 1U)
+			drop_newest_();
+	}
+
+	[[nodiscard]] constexpr auto history_limit() const noexcept -> size_t
+	{
+		return limit_;
+	}
+
+	// Forgets the oldest values (and if still needed the undone ones) so that
+	// no more than `limit` are held.
+	constexpr auto set_history_limit(size_t limit) noexcept -> void
+	{
+		assert(limit > 0U);
+		limit_ = limit;
+		for(; count_ > limit_ && current_ != 0U; current_--)
+			drop_oldest_();
+		while(count_ > limit_)
+			drop_newest_();
+	}
+
+	// Amount of values held, the current one included.
+	[[nodiscard]] constexpr auto history_size() const noexcept -> size_t
+	{
+		return count_;
+	}
+
+	// Bytes used to hold the values, not counting memory the values own.
+	[[nodiscard]] constexpr auto memory_usage() const noexcept -> size_t
+	{
+		return values_.capacity() * sizeof(ValueType);
+	}
+
+	[[nodiscard]] constexpr auto position() const noexcept -> PositionType
+	{
+		return base_ + current_;
+	}
+
+	// Jump directly to a value previously returned by `position`, same as
+	// undoing or redoing all the assignments in between.
+	constexpr auto seek(PositionType pos) noexcept -> void
+	{
+		assert(pos >= base_ && pos - base_ < count_);
+		current_ = pos - base_;
 	}
 
 	// FIXME: Too lazy to do something else, should probably be optimized
@@ -60,9 +126,10 @@ public:
 	template<typename... Args>
 	constexpr auto assign(Args&&... args) noexcept -> void
 	{
-		if(current_ == --values_.cend())
-			values_.emplace_back().assign(std::forward<Args>(args)...);
-		current_++;
+		if(current_ == count_ - 1U)
+			next_slot_().assign(std::forward<Args>(args)...);
+		else
+			current_++;
 	}
 
 	template<typename... Args>
@@ -88,8 +155,65 @@ public:
 	}
 
 private:
-	ContainerType values_;
-	typename ContainerType::const_iterator current_;
+	std::vector<ValueType> values_;
+	size_t limit_;
+	size_t head_;    // Slot of the oldest value held.
+	size_t count_;   // Amount of values held.
+	size_t current_; // Current value, relative to the oldest one.
+	size_t base_;    // Position of the oldest value held.
+
+	template<typename Self>
+	static constexpr auto at_(Self& self, size_t i) noexcept -> auto&
+	{
+		assert(i < self.count_);
+		return self.values_[(self.head_ + i) % self.values_.size()];
+	}
+
+	constexpr auto at_(size_t i) const noexcept -> ValueType const&
+	{
+		return at_(*this, i);
+	}
+
+	constexpr auto at_(size_t i) noexcept -> ValueType&
+	{
+		return at_(*this, i);
+	}
+
+	constexpr auto drop_newest_() noexcept -> void
+	{
+		assert(count_ > 0U);
+		at_(count_ - 1U) = ValueType{};
+		count_--;
+	}
+
+	constexpr auto drop_oldest_() noexcept -> void
+	{
+		assert(count_ > 0U);
+		values_[head_] = ValueType{};
+		head_ = (head_ + 1U) % values_.size();
+		count_--;
+		base_++;
+	}
+
+	// Makes room for a value after the last one held and makes it the
+	// current one. Only valid when at the last value.
+	constexpr auto next_slot_() noexcept -> ValueType&
+	{
+		assert(current_ == count_ - 1U);
+		if(count_ == limit_)
+			drop_oldest_();
+		else if(count_ == values_.size())
+		{
+			// Grow, leaving the oldest value at the first slot.
+			auto const size = std::min(values_.size() * 2U, limit_);
+			std::rotate(values_.begin(), values_.begin() + head_,
+			            values_.end());
+			values_.resize(size);
+			head_ = 0U;
+		}
+		current_ = count_++;
+		return at_(current_);
+	}
 };
 
 } // namespace YGOpen::Client
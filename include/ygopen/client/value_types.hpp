@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_CLIENT_VALUE_TYPES_HPP
+#define YGOPEN_CLIENT_VALUE_TYPES_HPP
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <ygopen/duel/constants/controller.hpp>
+#include <ygopen/duel/constants/location.hpp>
+#include <ygopen/proto/duel/data.hpp>
+
+// Trivially copyable mirrors of the protobuf messages from duel_data.proto
+// that are kept around as values (stacks, map keys, ...). They expose the same
+// getters and setters, so they can be given to BasicFrame as places, and are
+// implicitly constructible from their protobuf counterpart, so containers of
+// them can be given to `parse_event`.
+//
+// NOTE: PlaceValue stores its members in fewer bits than the protobuf message.
+// A place with a member that does not fit becomes the empty place (see
+// `is_empty`), which holds no cards, instead of aliasing another one.
+
+namespace YGOpen::Client
+{
+
+class PlaceValue
+{
+public:
+	constexpr PlaceValue() noexcept = default;
+
+	constexpr PlaceValue(int32_t con, uint32_t loc, uint32_t seq,
+	                     int32_t oseq) noexcept
+		: con_(static_cast<int8_t>(con))
+		, loc_(static_cast<uint16_t>(loc))
+		, seq_(static_cast<uint16_t>(seq))
+		, oseq_(static_cast<int16_t>(oseq))
+	{
+		if(con_ != con || loc_ != loc || seq_ != seq || oseq_ != oseq)
+			*this = PlaceValue{};
+	}
+
+	// NOTE: Implicit on purpose, see top of the file.
+	PlaceValue(Proto::Duel::Place const& p) noexcept
+		: PlaceValue(p.con(), p.loc(), p.seq(), p.oseq())
+	{}
+
+	[[nodiscard]] constexpr auto con() const noexcept -> int32_t
+	{
+		return con_;
+	}
+
+	[[nodiscard]] constexpr auto loc() const noexcept -> uint32_t
+	{
+		return loc_;
+	}
+
+	[[nodiscard]] constexpr auto seq() const noexcept -> uint32_t
+	{
+		return seq_;
+	}
+
+	[[nodiscard]] constexpr auto oseq() const noexcept -> int32_t
+	{
+		return oseq_;
+	}
+
+	constexpr auto set_con(int32_t con) noexcept -> void
+	{
+		con_ = static_cast<int8_t>(con);
+		if(con_ != con)
+			*this = PlaceValue{};
+	}
+
+	constexpr auto set_loc(uint32_t loc) noexcept -> void
+	{
+		loc_ = static_cast<uint16_t>(loc);
+		if(loc_ != loc)
+			*this = PlaceValue{};
+	}
+
+	constexpr auto set_seq(uint32_t seq) noexcept -> void
+	{
+		seq_ = static_cast<uint16_t>(seq);
+		if(seq_ != seq)
+			*this = PlaceValue{};
+	}
+
+	constexpr auto set_oseq(int32_t oseq) noexcept -> void
+	{
+		oseq_ = static_cast<int16_t>(oseq);
+		if(oseq_ != oseq)
+			*this = PlaceValue{};
+	}
+
+	// All members packed in an integer that orders the same as PlaceLess.
+	[[nodiscard]] constexpr auto key() const noexcept -> uint64_t
+	{
+		// NOTE: Flipping the sign bit maps signed order onto unsigned order.
+		auto const con = static_cast<uint8_t>(con_) ^ 0x80U;
+		auto const oseq = static_cast<uint16_t>(oseq_) ^ 0x8000U;
+		return (uint64_t{con} << 48U) | (uint64_t{loc_} << 32U) |
+		       (uint64_t{seq_} << 16U) | uint64_t{oseq};
+	}
+
+	// Inverse of `key`.
+	[[nodiscard]] static constexpr auto from_key(uint64_t key) noexcept
+		-> PlaceValue
+	{
+		PlaceValue p;
+		p.con_ = static_cast<int8_t>(static_cast<uint8_t>(key >> 48U) ^ 0x80U);
+		p.loc_ = static_cast<uint16_t>(key >> 32U);
+		p.seq_ = static_cast<uint16_t>(key >> 16U);
+		p.oseq_ = static_cast<int16_t>(static_cast<uint16_t>(key) ^ 0x8000U);
+		return p;
+	}
+
+private:
+	int8_t con_{};
+	uint16_t loc_{};
+	uint16_t seq_{};
+	int16_t oseq_{};
+};
+
+static_assert(std::is_trivially_copyable_v<PlaceValue>);
+static_assert(sizeof(PlaceValue) == sizeof(uint64_t));
+
+class EffectValue
+{
+public:
+	constexpr EffectValue() noexcept = default;
+
+	constexpr EffectValue(uint32_t code, uint32_t index) noexcept
+		: code_(code), index_(index)
+	{}
+
+	// NOTE: Implicit on purpose, see top of the file.
+	EffectValue(Proto::Duel::Effect const& e) noexcept
+		: EffectValue(e.code(), e.index())
+	{}
+
+	[[nodiscard]] constexpr auto code() const noexcept -> uint32_t
+	{
+		return code_;
+	}
+
+	[[nodiscard]] constexpr auto index() const noexcept -> uint32_t
+	{
+		return index_;
+	}
+
+	constexpr auto set_code(uint32_t code) noexcept -> void { code_ = code; }
+
+	constexpr auto set_index(uint32_t index) noexcept -> void
+	{
+		index_ = index;
+	}
+
+private:
+	uint32_t code_{};
+	uint32_t index_{};
+};
+
+class CounterValue
+{
+public:
+	constexpr CounterValue() noexcept = default;
+
+	constexpr CounterValue(uint32_t type, uint32_t count) noexcept
+		: type_(type), count_(count)
+	{}
+
+	// NOTE: Implicit on purpose, see top of the file.
+	CounterValue(Proto::Duel::Counter const& c) noexcept
+		: CounterValue(c.type(), c.count())
+	{}
+
+	[[nodiscard]] constexpr auto type() const noexcept -> uint32_t
+	{
+		return type_;
+	}
+
+	[[nodiscard]] constexpr auto count() const noexcept -> uint32_t
+	{
+		return count_;
+	}
+
+	constexpr auto set_type(uint32_t type) noexcept -> void { type_ = type; }
+
+	constexpr auto set_count(uint32_t count) noexcept -> void
+	{
+		count_ = count;
+	}
+
+private:
+	uint32_t type_{};
+	uint32_t count_{};
+};
+
+class ChainValue
+{
+public:
+	constexpr ChainValue() noexcept = default;
+
+	constexpr ChainValue(PlaceValue card_place, PlaceValue place,
+	                     EffectValue effect) noexcept
+		: card_place_(card_place), place_(place), effect_(effect)
+	{}
+
+	// NOTE: Implicit on purpose, see top of the file.
+	ChainValue(Proto::Duel::Chain const& c) noexcept
+		: ChainValue(c.card_place(), c.place(), c.effect())
+	{}
+
+	[[nodiscard]] constexpr auto card_place() const noexcept
+		-> PlaceValue const&
+	{
+		return card_place_;
+	}
+
+	[[nodiscard]] constexpr auto place() const noexcept -> PlaceValue const&
+	{
+		return place_;
+	}
+
+	[[nodiscard]] constexpr auto effect() const noexcept -> EffectValue const&
+	{
+		return effect_;
+	}
+
+	[[nodiscard]] constexpr auto mutable_card_place() noexcept -> PlaceValue*
+	{
+		return &card_place_;
+	}
+
+	[[nodiscard]] constexpr auto mutable_place() noexcept -> PlaceValue*
+	{
+		return &place_;
+	}
+
+	[[nodiscard]] constexpr auto mutable_effect() noexcept -> EffectValue*
+	{
+		return &effect_;
+	}
+
+private:
+	PlaceValue card_place_;
+	PlaceValue place_;
+	EffectValue effect_;
+};
+
+static_assert(std::is_trivially_copyable_v<ChainValue>);
+
+// Comparisons.
+
+[[nodiscard]] constexpr auto operator==(PlaceValue const& lhs,
+                                        PlaceValue const& rhs) noexcept -> bool
+{
+	return lhs.key() == rhs.key();
+}
+
+[[nodiscard]] constexpr auto operator!=(PlaceValue const& lhs,
+                                        PlaceValue const& rhs) noexcept -> bool
+{
+	return lhs.key() != rhs.key();
+}
+
+[[nodiscard]] constexpr auto operator<(PlaceValue const& lhs,
+                                       PlaceValue const& rhs) noexcept -> bool
+{
+	return lhs.key() < rhs.key();
+}
+
+[[nodiscard]] constexpr auto operator==(EffectValue const& lhs,
+                                        EffectValue const& rhs) noexcept -> bool
+{
+	return lhs.code() == rhs.code() && lhs.index() == rhs.index();
+}
+
+[[nodiscard]] constexpr auto operator==(CounterValue const& lhs,
+                                        CounterValue const& rhs) noexcept
+	-> bool
+{
+	return lhs.type() == rhs.type() && lhs.count() == rhs.count();
+}
+
+[[nodiscard]] constexpr auto operator==(ChainValue const& lhs,
+                                        ChainValue const& rhs) noexcept -> bool
+{
+	return lhs.card_place() == rhs.card_place() &&
+	       lhs.place() == rhs.place() && lhs.effect() == rhs.effect();
+}
+
+// Same helpers as <ygopen/proto/duel/data.hpp>.
+
+[[nodiscard]] constexpr auto get_con(PlaceValue const& place) noexcept -> auto
+{
+	return static_cast<YGOpen::Duel::Controller>(place.con());
+}
+
+[[nodiscard]] constexpr auto get_loc(PlaceValue const& place) noexcept -> auto
+{
+	return static_cast<YGOpen::Duel::Location>(place.loc());
+}
+
+[[nodiscard]] constexpr auto is_empty(PlaceValue const& place) noexcept -> bool
+{
+	return YGOpen::Duel::is_empty(get_loc(place));
+}
+
+[[nodiscard]] constexpr auto is_pile(PlaceValue const& place) noexcept -> bool
+{
+	return YGOpen::Duel::is_pile(get_loc(place));
+}
+
+[[nodiscard]] constexpr auto is_zone(PlaceValue const& place) noexcept -> bool
+{
+	return YGOpen::Duel::is_zone(get_loc(place));
+}
+
+// Conversions back to protobuf.
+
+inline auto to_proto(PlaceValue const& value, Proto::Duel::Place& p) noexcept
+	-> void
+{
+	p.set_con(value.con());
+	p.set_loc(value.loc());
+	p.set_seq(value.seq());
+	p.set_oseq(value.oseq());
+}
+
+inline auto to_proto(EffectValue const& value, Proto::Duel::Effect& e) noexcept
+	-> void
+{
+	e.set_code(value.code());
+	e.set_index(value.index());
+}
+
+inline auto to_proto(CounterValue const& value,
+                     Proto::Duel::Counter& c) noexcept -> void
+{
+	c.set_type(value.type());
+	c.set_count(value.count());
+}
+
+inline auto to_proto(ChainValue const& value, Proto::Duel::Chain& c) noexcept
+	-> void
+{
+	to_proto(value.card_place(), *c.mutable_card_place());
+	to_proto(value.place(), *c.mutable_place());
+	to_proto(value.effect(), *c.mutable_effect());
+}
+
+// Same as above but for values that already are protobuf messages, so generic
+// code can convert either.
+
+inline auto to_proto(Proto::Duel::Place const& value,
+                     Proto::Duel::Place& p) noexcept -> void
+{
+	p = value;
+}
+
+inline auto to_proto(Proto::Duel::Counter const& value,
+                     Proto::Duel::Counter& c) noexcept -> void
+{
+	c = value;
+}
+
+inline auto to_proto(Proto::Duel::Chain const& value,
+                     Proto::Duel::Chain& c) noexcept -> void
+{
+	c = value;
+}
+
+} // namespace YGOpen::Client
+
+namespace std
+{
+
+template<>
+struct hash<YGOpen::Client::PlaceValue>
+{
+	auto operator()(YGOpen::Client::PlaceValue const& p) const noexcept
+		-> size_t
+	{
+		return hash<uint64_t>{}(p.key());
+	}
+};
+
+} // namespace std
+
+#endif // YGOPEN_CLIENT_VALUE_TYPES_HPP
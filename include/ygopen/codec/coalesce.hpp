@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2024, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_CODEC_COALESCE_HPP
+#define YGOPEN_CODEC_COALESCE_HPP
+#include <cstddef> // size_t
+
+namespace google::protobuf
+{
+
+template<typename Element>
+class RepeatedPtrField;
+
+} // namespace google::protobuf
+
+namespace YGOpen
+{
+
+namespace Proto::Duel
+{
+
+class Msg;
+
+} // namespace Proto::Duel
+
+namespace Codec
+{
+
+// Merge runs of consecutive events that can be expressed as a single one,
+// namely card adds, moves and removes, pile splices and LP changes of the same
+// kind, reason and (for LP) controller. Operations keep their relative order,
+// so parsing (or undoing) the merged event has the same effect as the whole
+// run. Meant to be used on the output of `encode_all`, after the context has
+// parsed it. Returns the number of messages removed from `msgs`.
+auto coalesce(
+	google::protobuf::RepeatedPtrField<Proto::Duel::Msg>& msgs) noexcept
+	-> size_t;
+
+} // namespace Codec
+
+} // namespace YGOpen
+
+#endif // YGOPEN_CODEC_COALESCE_HPP
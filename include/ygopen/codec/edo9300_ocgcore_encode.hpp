@@ -18,6 +18,53 @@ namespace YGOpen::Codec::Edo9300::OCGCore
                               IEncodeContext& context,
                               uint8_t const* data) noexcept -> EncodeOneResult;
 
+// Same as above, but calls into `context` are resolved statically, so they can
+// be inlined. Defined in edo9300_ocgcore_encode.inl, which must be included
+// to use it with a context the library is not built with.
+template<YGOPEN_CONCEPT(EncodeContext)>
+[[nodiscard]] auto encode_one(google::protobuf::Arena& arena,
+                              EncodeContext& context,
+                              uint8_t const* data) noexcept -> EncodeOneResult;
+
+// Same as `encode_one` but the message is encoded into `scratch` (cleared
+// first) and its wire bytes appended to `out`, which are identical to what
+// serializing the message returned by `encode_one` would yield. Meant to be
+// called with the same `scratch` over and over, so the object graph is
+// recycled instead of allocated anew for each message that is sent. On
+// success, `msg` points to `scratch`, so it can still be given to the context.
+// If `out` could not be written to, `SERIALIZE_FAILED` is returned instead,
+// with `msg` still pointing to `scratch`.
+// NOTE: Unless `context.needs_queries()`, MSG_UPDATE_DATA and MSG_UPDATE_CARD
+// are written straight to `out` without building them, in which case `msg`
+// is null and `scratch` is left untouched.
+[[nodiscard]] auto encode_one(IEncodeContext& context, uint8_t const* data,
+                              Proto::Duel::Msg& scratch,
+                              std::string& out) noexcept -> EncodeOneResult;
+
+[[nodiscard]] auto encode_one(
+	IEncodeContext& context, uint8_t const* data, Proto::Duel::Msg& scratch,
+	google::protobuf::io::ZeroCopyOutputStream& out) noexcept
+	-> EncodeOneResult;
+
+// Encode an entire buffer as returned by `OCG_DuelGetMessage`: a sequence of
+// core messages, each one prefixed by its length. Every message that is not
+// swallowed is constructed in place at the end of `out` (so if `out` lives in
+// an arena, so do the messages) and handed to `context.parse` before encoding
+// the next one; those the context leaves empty are removed again. Unknown
+// messages are skipped using their length prefix, as are malformed ones (see
+// `EncodeAllResult`).
+[[nodiscard]] auto encode_all(
+	IEncodeContext& context, uint8_t const* data, size_t size,
+	google::protobuf::RepeatedPtrField<Proto::Duel::Msg>& out) noexcept
+	-> EncodeAllResult;
+
+// See the templated `encode_one`.
+template<YGOPEN_CONCEPT(EncodeContext)>
+[[nodiscard]] auto encode_all(
+	EncodeContext& context, uint8_t const* data, size_t size,
+	google::protobuf::RepeatedPtrField<Proto::Duel::Msg>& out) noexcept
+	-> EncodeAllResult;
+
 } // namespace YGOpen::Codec::Edo9300::OCGCore
 
 #endif // YGOPEN_CODEC_EDO9300_OCGCORE_ENCODE_HPP
@@ -7,7 +7,9 @@
 #define YGOPEN_CODEC_ENCODE_COMMON_HPP
 #include <cstddef> // size_t
 #include <cstdint>
+#include <string>
 #include <vector>
+#include <ygopen/detail/config.hpp>
 #include <ygopen/duel/constants_fwd.hpp>
 
 namespace google::protobuf
@@ -15,6 +17,16 @@ namespace google::protobuf
 
 class Arena;
 
+template<typename Element>
+class RepeatedPtrField;
+
+namespace io
+{
+
+class ZeroCopyOutputStream;
+
+} // namespace io
+
 } // namespace google::protobuf
 
 namespace YGOpen
@@ -51,18 +63,39 @@ struct EncodeOneResult
 		UNKNOWN,
 		// Buffer was correctly encoded.
 		// `bytes_read` has non-0 value.
-		// `msg` is non-null.
+		// `msg` is non-null, unless the message was written straight to the
+		// output (see `IEncodeContext::needs_queries`).
 		OK,
 		// The encoder knows the message type but will not encode it because
 		// encoding this message alone yields no useful information.
 		// `bytes_read` has number of bytes that were read or skipped.
 		// `msg` is null.
 		SWALLOWED,
+		// Buffer was correctly encoded but writing the serialized message to
+		// the output failed; only returned by the overloads that serialize.
+		// `bytes_read` has non-0 value.
+		// `msg` is the same as it would have been for `OK`.
+		SERIALIZE_FAILED,
 	} state;
 	size_t bytes_read;
 	Proto::Duel::Msg* msg;
 };
 
+struct EncodeAllResult
+{
+	// Number of core messages found in the buffer.
+	size_t msgs_read;
+	// Number of core messages the encoder didn't know and skipped over.
+	size_t unknown_count;
+	// Number of core messages dropped because they were empty or shorter
+	// than their contents, in which case they are not given to the context
+	// nor change it. Such messages are never read past their size.
+	size_t malformed_count;
+	// Number of bytes consumed. Less than the size of the buffer only if the
+	// last message was truncated.
+	size_t bytes_read;
+};
+
 class IEncodeContext
 {
 public:
@@ -92,16 +125,69 @@ public:
 	// the field.
 	virtual auto xyz_mat_defer(Place const&) noexcept -> void = 0;
 
-	// Get all places set with `xyz_mat_defer` and clear internal list.
-	virtual auto take_deferred_xyz_mat() noexcept -> std::vector<Place> = 0;
+	// Get all places set with `xyz_mat_defer`.
+	// NOTE: Together with `clear_deferred_xyz_mat`, replaces the former
+	// `take_deferred_xyz_mat`. Contexts implementing it should return their
+	// list here and clear it in `clear_deferred_xyz_mat`, which the encoder
+	// calls once it is done with the list.
+	[[nodiscard]] virtual auto deferred_xyz_mat() const noexcept
+		-> std::vector<Place> const& = 0;
+
+	// Clear all places set with `xyz_mat_defer`.
+	virtual auto clear_deferred_xyz_mat() noexcept -> void = 0;
 
 	// A card that had xyz materials left the field to a different place.
 	virtual auto xyz_left(Place const&, Place const&) noexcept -> void = 0;
 
+	// Apply a message that was just encoded, so that the following messages
+	// are encoded on top of the resulting state. The context may remove from
+	// the message information that was already sent, so this should be called
+	// before sending it. Returns false if nothing is left in the message, in
+	// which case it should not be sent at all.
+	[[nodiscard]] virtual auto parse(Proto::Duel::Msg&) noexcept -> bool = 0;
+
+	// Whether `parse` makes any use of queries. If not, messages that only
+	// carry queries may be written straight to the wire by the encoder,
+	// without ever building a `Msg` that could be parsed.
+	[[nodiscard]] virtual auto needs_queries() const noexcept -> bool
+	{
+		return true;
+	}
+
 protected:
 	~IEncodeContext() noexcept = default;
 };
 
+#ifdef YGOPEN_HAS_CONCEPTS
+// Same requirements as `IEncodeContext`, without requiring inheritance.
+template<typename T>
+concept EncodeContext =
+	requires(T& c, T const& cc, Duel::Controller con, Duel::Location loc,
+	         Proto::Duel::Place const& p, Proto::Duel::Msg& msg)
+{
+	{
+		cc.pile_size(con, loc)
+	} noexcept;
+	{
+		cc.get_match_win_reason()
+	} noexcept;
+	{
+		cc.has_xyz_mat(p)
+	} noexcept;
+	{
+		cc.get_xyz_left(p)
+	} noexcept;
+	{
+		cc.deferred_xyz_mat()
+	} noexcept;
+	c.match_win_reason(uint32_t{});
+	c.xyz_mat_defer(p);
+	c.clear_deferred_xyz_mat();
+	c.xyz_left(p, p);
+	static_cast<bool>(c.parse(msg));
+};
+#endif // YGOPEN_HAS_CONCEPTS
+
 } // namespace Codec
 
 } // namespace YGOpen
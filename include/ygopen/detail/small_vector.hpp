@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_DETAIL_SMALL_VECTOR_HPP
+#define YGOPEN_DETAIL_SMALL_VECTOR_HPP
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <type_traits>
+
+namespace YGOpen::Detail
+{
+
+// Vector of trivially copyable elements that keeps the first `N` of them
+// inline, only allocating if it ever grows past that. The heap pointer shares
+// storage with the inline elements, so the overhead over them is 8 bytes.
+// Implements the subset of std::vector's interface used throughout the library.
+template<typename T, size_t N>
+class SmallVector
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+	static_assert(N > 0U);
+
+public:
+	using value_type = T;
+	using size_type = size_t;
+	using iterator = T*;
+	using const_iterator = T const*;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	explicit SmallVector() noexcept = default;
+
+	SmallVector(SmallVector const& other) noexcept { assign_(other); }
+
+	SmallVector(SmallVector&& other) noexcept { steal_(other); }
+
+	auto operator=(SmallVector const& other) noexcept -> SmallVector&
+	{
+		if(this != &other)
+			assign_(other);
+		return *this;
+	}
+
+	auto operator=(SmallVector&& other) noexcept -> SmallVector&
+	{
+		if(this != &other)
+			steal_(other);
+		return *this;
+	}
+
+	~SmallVector() noexcept { free_(); }
+
+	// Element access.
+
+	[[nodiscard]] auto operator[](size_t i) noexcept -> T&
+	{
+		assert(i < size_);
+		return data()[i];
+	}
+
+	[[nodiscard]] auto operator[](size_t i) const noexcept -> T const&
+	{
+		assert(i < size_);
+		return data()[i];
+	}
+
+	[[nodiscard]] auto back() noexcept -> T&
+	{
+		assert(size_ != 0U);
+		return data()[size_ - 1U];
+	}
+
+	[[nodiscard]] auto back() const noexcept -> T const&
+	{
+		assert(size_ != 0U);
+		return data()[size_ - 1U];
+	}
+
+	[[nodiscard]] auto data() noexcept -> T*
+	{
+		return is_inline_() ? inline_ : heap_;
+	}
+
+	[[nodiscard]] auto data() const noexcept -> T const*
+	{
+		return is_inline_() ? inline_ : heap_;
+	}
+
+	// Iterators.
+
+	[[nodiscard]] auto begin() noexcept -> iterator { return data(); }
+	[[nodiscard]] auto end() noexcept -> iterator { return data() + size_; }
+
+	[[nodiscard]] auto begin() const noexcept -> const_iterator
+	{
+		return data();
+	}
+
+	[[nodiscard]] auto end() const noexcept -> const_iterator
+	{
+		return data() + size_;
+	}
+
+	[[nodiscard]] auto cbegin() const noexcept -> const_iterator
+	{
+		return begin();
+	}
+
+	[[nodiscard]] auto cend() const noexcept -> const_iterator { return end(); }
+
+	[[nodiscard]] auto rbegin() noexcept -> reverse_iterator
+	{
+		return reverse_iterator(end());
+	}
+
+	[[nodiscard]] auto rend() noexcept -> reverse_iterator
+	{
+		return reverse_iterator(begin());
+	}
+
+	[[nodiscard]] auto crbegin() const noexcept -> const_reverse_iterator
+	{
+		return const_reverse_iterator(cend());
+	}
+
+	[[nodiscard]] auto crend() const noexcept -> const_reverse_iterator
+	{
+		return const_reverse_iterator(cbegin());
+	}
+
+	// Capacity.
+
+	[[nodiscard]] auto empty() const noexcept -> bool { return size_ == 0U; }
+
+	[[nodiscard]] auto size() const noexcept -> size_t { return size_; }
+
+	[[nodiscard]] auto capacity() const noexcept -> size_t
+	{
+		return capacity_;
+	}
+
+	auto reserve(size_t n) noexcept -> void
+	{
+		if(n <= capacity_)
+			return;
+		auto const new_capacity = std::max<size_t>(n, capacity_ * 2U);
+		assert(new_capacity <= std::numeric_limits<SizeType>::max());
+		auto* heap = new T[new_capacity];
+		std::memcpy(heap, data(), size_ * sizeof(T));
+		free_();
+		heap_ = heap;
+		capacity_ = static_cast<SizeType>(new_capacity);
+	}
+
+	// Modifiers.
+
+	auto clear() noexcept -> void { size_ = 0U; }
+
+	template<typename InputIt>
+	auto assign(InputIt first, InputIt last) noexcept -> void
+	{
+		clear();
+		insert(cend(), first, last);
+	}
+
+	auto push_back(T const& value) noexcept -> void
+	{
+		reserve(size_ + 1U);
+		data()[size_++] = value;
+	}
+
+	auto pop_back() noexcept -> void
+	{
+		assert(size_ != 0U);
+		size_--;
+	}
+
+	auto resize(size_t n) noexcept -> void
+	{
+		reserve(n);
+		if(n > size_)
+			std::fill(data() + size_, data() + n, T{});
+		size_ = static_cast<SizeType>(n);
+	}
+
+	auto insert(const_iterator pos, T const& value) noexcept -> iterator
+	{
+		T const copy = value;
+		return insert(pos, &copy, &copy + 1);
+	}
+
+	template<typename InputIt>
+	auto insert(const_iterator pos, InputIt first, InputIt last) noexcept
+		-> iterator
+	{
+		auto const index = static_cast<size_t>(pos - cbegin());
+		auto const count = static_cast<size_t>(std::distance(first, last));
+		assert(index <= size_);
+		// NOTE: Shifting or growing invalidates the range if it points into us.
+		if constexpr(std::is_pointer_v<InputIt>)
+		{
+			if(std::less_equal<>{}(cbegin(), first) &&
+			   std::less<>{}(first, cend()))
+			{
+				SmallVector tmp;
+				tmp.insert(tmp.cend(), first, last);
+				return insert(cbegin() + index, tmp.cbegin(), tmp.cend());
+			}
+		}
+		reserve(size_ + count);
+		auto* const p = data() + index;
+		std::memmove(p + count, p, (size_ - index) * sizeof(T));
+		std::copy(first, last, p);
+		size_ += static_cast<SizeType>(count);
+		return p;
+	}
+
+	auto erase(const_iterator pos) noexcept -> iterator
+	{
+		return erase(pos, pos + 1);
+	}
+
+	auto erase(const_iterator first, const_iterator last) noexcept -> iterator
+	{
+		auto const index = static_cast<size_t>(first - cbegin());
+		auto const count = static_cast<size_t>(last - first);
+		assert(index + count <= size_);
+		auto* const p = data() + index;
+		std::memmove(p, p + count, (size_ - index - count) * sizeof(T));
+		size_ -= static_cast<SizeType>(count);
+		return p;
+	}
+
+private:
+	using SizeType = uint32_t;
+
+	// NOTE: Which member is active depends on the capacity.
+	union
+	{
+		T inline_[N]{};
+		T* heap_;
+	};
+	SizeType size_{};
+	SizeType capacity_{N};
+
+	auto is_inline_() const noexcept -> bool { return capacity_ == N; }
+
+	auto free_() noexcept -> void
+	{
+		if(!is_inline_())
+			delete[] heap_;
+	}
+
+	auto assign_(SmallVector const& other) noexcept -> void
+	{
+		size_ = 0U;
+		reserve(other.size_);
+		std::memcpy(data(), other.data(), other.size_ * sizeof(T));
+		size_ = other.size_;
+	}
+
+	auto steal_(SmallVector& other) noexcept -> void
+	{
+		if(!other.is_inline_())
+		{
+			free_();
+			heap_ = std::exchange(other.heap_, nullptr);
+			size_ = other.size_;
+			capacity_ = other.capacity_;
+		}
+		else
+		{
+			assign_(other);
+		}
+		other.size_ = 0U;
+		other.capacity_ = N;
+	}
+};
+
+template<typename T, size_t N>
+[[nodiscard]] auto operator==(SmallVector<T, N> const& lhs,
+                              SmallVector<T, N> const& rhs) noexcept -> bool
+{
+	return std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+}
+
+template<typename T, size_t N>
+[[nodiscard]] auto operator!=(SmallVector<T, N> const& lhs,
+                              SmallVector<T, N> const& rhs) noexcept -> bool
+{
+	return !(lhs == rhs);
+}
+
+} // namespace YGOpen::Detail
+
+#endif // YGOPEN_DETAIL_SMALL_VECTOR_HPP
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_DETAIL_SPSC_RING_HPP
+#define YGOPEN_DETAIL_SPSC_RING_HPP
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace YGOpen::Detail
+{
+
+// Fixed-capacity ring of `T` for exactly one producer thread and one consumer
+// thread, without locks. Slots are constructed once and reused: the producer
+// fills the slot at `back` in place and publishes it with `push`, the consumer
+// uses the slot at `front` in place and hands it back with `pop`. So objects
+// owning memory (buffers, messages) keep it from one lap to the next.
+template<typename T>
+class SpscRing
+{
+public:
+	// `capacity` is rounded up to a power of two.
+	explicit SpscRing(size_t capacity) noexcept
+		: mask_(round_up_(capacity) - 1U)
+		, slots_(std::make_unique<T[]>(mask_ + 1U))
+	{}
+
+	SpscRing(SpscRing const&) = delete;
+	auto operator=(SpscRing const&) -> SpscRing& = delete;
+
+	[[nodiscard]] auto capacity() const noexcept -> size_t
+	{
+		return mask_ + 1U;
+	}
+
+	// NOTE: Only exact when called from either end while the other is idle,
+	// but safe from any thread: `head_` is loaded first and `tail_` never
+	// falls behind it, so the result does not underflow.
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		auto const head = head_.load(std::memory_order_acquire);
+		return tail_.load(std::memory_order_acquire) - head;
+	}
+
+	// Producer side. Free slot to fill, null if the ring is full.
+	[[nodiscard]] auto back() noexcept -> T*
+	{
+		auto const tail = tail_.load(std::memory_order_relaxed);
+		if(tail - head_cache_ > mask_)
+		{
+			head_cache_ = head_.load(std::memory_order_acquire);
+			if(tail - head_cache_ > mask_)
+				return nullptr;
+		}
+		return &slots_[tail & mask_];
+	}
+
+	// Producer side. Publishes the slot returned by `back`.
+	auto push() noexcept -> void
+	{
+		auto const tail = tail_.load(std::memory_order_relaxed);
+		tail_.store(tail + 1U, std::memory_order_release);
+	}
+
+	// Consumer side. Oldest published slot, null if the ring is empty.
+	[[nodiscard]] auto front() noexcept -> T*
+	{
+		auto const head = head_.load(std::memory_order_relaxed);
+		if(head == tail_cache_)
+		{
+			tail_cache_ = tail_.load(std::memory_order_acquire);
+			if(head == tail_cache_)
+				return nullptr;
+		}
+		return &slots_[head & mask_];
+	}
+
+	// Consumer side. Hands the slot returned by `front` back to the producer.
+	auto pop() noexcept -> void
+	{
+		auto const head = head_.load(std::memory_order_relaxed);
+		head_.store(head + 1U, std::memory_order_release);
+	}
+
+private:
+	// NOTE: Keeps each end's counters off the other end's cache line.
+	static constexpr size_t CACHE_LINE = 64U;
+
+	static constexpr auto round_up_(size_t n) noexcept -> size_t
+	{
+		size_t p = 1U;
+		while(p < n)
+			p <<= 1U;
+		return p;
+	}
+
+	size_t const mask_;
+	std::unique_ptr<T[]> const slots_;
+	// Written by the producer.
+	alignas(CACHE_LINE) std::atomic<size_t> tail_{0U};
+	size_t head_cache_{0U};
+	// Written by the consumer.
+	alignas(CACHE_LINE) std::atomic<size_t> head_{0U};
+	size_t tail_cache_{0U};
+};
+
+} // namespace YGOpen::Detail
+
+#endif // YGOPEN_DETAIL_SPSC_RING_HPP
@@ -50,6 +50,13 @@ struct PlaceLess
 	return !PlaceLess{}(lhs, rhs) && !PlaceLess{}(rhs, lhs);
 }
 
+// Check equivalence only of protobuf-exposed methods.
+[[nodiscard]] inline auto operator==(Counter const& lhs,
+                                     Counter const& rhs) noexcept -> bool
+{
+	return lhs.type() == rhs.type() && lhs.count() == rhs.count();
+}
+
 [[nodiscard]] inline auto get_con(Place const& place) noexcept -> auto
 {
 	return static_cast<YGOpen::Duel::Controller>(place.con());
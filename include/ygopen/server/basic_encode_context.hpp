@@ -5,14 +5,17 @@
  */
 #ifndef YGOPEN_SERVER_BASIC_ENCODE_CONTEXT_HPP
 #define YGOPEN_SERVER_BASIC_ENCODE_CONTEXT_HPP
-#include <map>
+#include <unordered_map>
 #include <vector>
 #include <ygopen/client/board.hpp>
 #include <ygopen/client/card.hpp>
+#include <ygopen/client/card_storage.hpp>
 #include <ygopen/client/default_card_traits.hpp>
 #include <ygopen/client/frame.hpp>
 #include <ygopen/client/parse_event.hpp>
 #include <ygopen/client/parse_query.hpp>
+#include <ygopen/client/pile_storage.hpp>
+#include <ygopen/client/value_types.hpp>
 #include <ygopen/codec/encode_common.hpp>
 #include <ygopen/proto/duel/data.hpp>
 #include <ygopen/proto/duel/msg.hpp>
@@ -30,6 +33,22 @@ public:
 	using Loc = YGOpen::Codec::IEncodeContext::Loc;
 	using Place = YGOpen::Codec::IEncodeContext::Place;
 
+	BasicEncodeContext() noexcept = default;
+
+	// If `delta_queries` is true, `parse` removes from each query the values
+	// the card already had, so only what changed is sent. Receivers must have
+	// parsed every message given before, in order, for this to be lossless.
+	//
+	// NOTE: This means every receiver gets every message, unfiltered: the
+	// same context cannot feed recipients that are sent a different view of
+	// the duel (hidden cards stripped per player) nor ones that join later
+	// (spectators). Receivers that missed messages, such as after a
+	// reconnect, must first be sent the whole board again (for instance,
+	// with `Client::diff` from an empty board) before any more deltas.
+	explicit BasicEncodeContext(bool delta_queries) noexcept
+		: delta_queries_(delta_queries)
+	{}
+
 	auto pile_size(Con con, Loc loc) const noexcept -> size_t override
 	{
 		return board_.frame().pile(con, loc).size();
@@ -47,7 +66,9 @@ public:
 
 	auto get_xyz_left(Place const& left) const noexcept -> Place override
 	{
-		return left_.find(left)->second;
+		Place place;
+		YGOpen::Client::to_proto(left_.find(left)->second, place);
+		return place;
 	}
 
 	auto match_win_reason(uint32_t reason) noexcept -> void override
@@ -60,9 +81,14 @@ public:
 		deferred_.emplace_back(place);
 	}
 
-	auto take_deferred_xyz_mat() noexcept -> std::vector<Place> override
+	auto deferred_xyz_mat() const noexcept -> std::vector<Place> const& override
+	{
+		return deferred_;
+	}
+
+	auto clear_deferred_xyz_mat() noexcept -> void override
 	{
-		return std::exchange(deferred_, {});
+		deferred_.clear();
 	}
 
 	auto xyz_left(Place const& left, Place const& from) noexcept
@@ -71,13 +97,38 @@ public:
 		left_[left] = from;
 	}
 
-	auto parse(YGOpen::Proto::Duel::Msg const& msg) noexcept -> void
+	auto parse(YGOpen::Proto::Duel::Msg& msg) noexcept -> bool override
 	{
 		if(msg.t_case() == YGOpen::Proto::Duel::Msg::kEvent)
 			parse_event(board_, msg.event());
-		for(auto const& query : msg.queries())
+		if(!delta_queries_)
+		{
+			for(auto const& query : msg.queries())
+				static_cast<void>(
+					YGOpen::Client::parse_query(board_.frame(), query));
+			return true;
+		}
+		// Strip values already sent, and queries that end up empty.
+		auto& queries = *msg.mutable_queries();
+		int kept = 0;
+		for(int i = 0; i < queries.size(); i++)
+		{
+			auto& query = *queries.Mutable(i);
 			static_cast<void>(
-				YGOpen::Client::parse_query(board_.frame(), query));
+				YGOpen::Client::parse_query_delta(board_.frame(), query));
+			if(query.data().ByteSizeLong() != 0U)
+				queries.SwapElements(i, kept++);
+		}
+		while(queries.size() > kept)
+			queries.RemoveLast();
+		return msg.t_case() != YGOpen::Proto::Duel::Msg::T_NOT_SET ||
+		       kept != 0;
+	}
+
+	// NOTE: Queries are only read back to strip them.
+	auto needs_queries() const noexcept -> bool override
+	{
+		return delta_queries_;
 	}
 
 private:
@@ -86,9 +137,12 @@ private:
 
 	struct BoardTraits
 	{
-		using BlockedZonesType = std::vector<YGOpen::Proto::Duel::Place>;
-		using ChainStackType = std::vector<YGOpen::Proto::Duel::Chain>;
-		using FrameType = YGOpen::Client::BasicFrame<CardType>;
+		using BlockedZonesType = std::vector<YGOpen::Client::PlaceValue>;
+		using ChainStackType = std::vector<YGOpen::Client::ChainValue>;
+		using FrameType = YGOpen::Client::BasicFrame<
+			CardType, YGOpen::Client::Detail::DefaultBuilder<CardType>,
+			YGOpen::Client::SlabCardStorage<CardType>,
+			YGOpen::Client::InlinePileStorage<CardType>>;
 		using LPType = uint32_t;
 		using PhaseType = YGOpen::Duel::Phase;
 		using TurnControllerType = YGOpen::Duel::Controller;
@@ -99,8 +153,10 @@ private:
 
 	BoardType board_;
 
-	uint32_t match_win_reason_;
-	std::map<Place, Place, YGOpen::Proto::Duel::PlaceLess> left_;
+	bool delta_queries_{};
+	uint32_t match_win_reason_{};
+	std::unordered_map<YGOpen::Client::PlaceValue, YGOpen::Client::PlaceValue>
+		left_;
 	std::vector<Place> deferred_;
 };
 
@@ -5,6 +5,7 @@
  */
 #ifndef YGOPEN_SERVER_DUEL_HPP
 #define YGOPEN_SERVER_DUEL_HPP
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <ygopen/proto/duel/data.hpp>
@@ -33,16 +34,41 @@ public:
 
 	struct Options // Whoever constructs a duel should take this as parameter.
 	{
+		// Called with each message, on the thread stepping the duel. See
+		// `MsgPipeline` to encode and send messages on another thread.
 		ProcessCallback process_cb;
 		Proto::Duel::Options duel_options;
 	};
 
+	// Parameters of a single `card_add` call.
+	struct CardSpec
+	{
+		Proto::Duel::Place place;
+		uint8_t owner_team;
+		uint8_t owner_duelist;
+		uint32_t code;
+		uint32_t pos;
+	};
+
 	virtual ~IDuel() noexcept = default;
 
 	virtual auto card_add(Proto::Duel::Place const& place, uint8_t owner_team,
 	                      uint8_t owner_duelist, uint32_t code,
 	                      uint32_t pos) noexcept -> void = 0;
-	// TODO: Interface to add multiple cards at once?
+
+	// Same as calling `card_add` with each of the `count` cards at `specs`, in
+	// order. Duels that can add cards faster in bulk (for instance, a whole
+	// deck when starting) should override this.
+	// FIXME: Use std::span if we ever move to >=C++20.
+	virtual auto cards_add(CardSpec const* specs, size_t count) noexcept
+		-> void
+	{
+		for(size_t i = 0U; i < count; i++)
+		{
+			auto const& s = specs[i];
+			card_add(s.place, s.owner_team, s.owner_duelist, s.code, s.pos);
+		}
+	}
 
 	// Process callback is guaranteed to not be called before this.
 	virtual auto start() noexcept -> void = 0;
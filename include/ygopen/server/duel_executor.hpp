@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_SERVER_DUEL_EXECUTOR_HPP
+#define YGOPEN_SERVER_DUEL_EXECUTOR_HPP
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <ygopen/server/duel.hpp>
+
+namespace YGOpen::Server
+{
+
+// Runs many duels on a fixed amount of worker threads. Each `start` or
+// `submit_answer` call of a duel is a step; steps of the same duel never run
+// concurrently nor out of order, but steps of different duels run in parallel
+// on whatever worker is free.
+//
+// Every worker has its own queue of duels with steps pending, and idle
+// workers steal from the queues of the others. A duel is only ever queued
+// once: answers submitted while it is queued or running are kept in its inbox
+// and delivered together in a single turn, up to `Options::batch_limit` at
+// once, after which the duel goes to the back of the queue so that a busy duel
+// does not hold back the rest. Duels scheduled from a worker (for instance,
+// answers submitted from a process callback) go to that worker's queue.
+//
+// NOTE: Duels are called on worker threads, so process callbacks must be
+// thread-safe, but a given duel only calls its callback from one thread at a
+// time.
+class DuelExecutor
+{
+public:
+	using DuelId = uint64_t;
+	using Answer = IDuel::Answer;
+
+	struct Options
+	{
+		// Amount of worker threads, 0 for one per hardware thread.
+		size_t worker_count = 0U;
+		// Most answers a duel is given before letting others run.
+		size_t batch_limit = 16U;
+	};
+
+	struct Metrics
+	{
+		// Duels waiting for a worker, in total and per worker queue.
+		size_t queue_depth;
+		std::vector<size_t> worker_queue_depths;
+		// Duels being run by the executor.
+		size_t duel_count;
+		// Steps run so far and how many duels were stolen between workers.
+		uint64_t steps;
+		uint64_t steals;
+	};
+
+	struct DuelMetrics
+	{
+		uint64_t steps;
+		// Answers submitted and not yet given to the duel.
+		size_t pending_answers;
+		// How long the duel's steps took (`start` or `submit_answer` calls).
+		std::chrono::nanoseconds last_step;
+		std::chrono::nanoseconds max_step;
+		std::chrono::nanoseconds total_step;
+	};
+
+	DuelExecutor() noexcept;
+	explicit DuelExecutor(Options const& options) noexcept;
+
+	// Waits for running steps to finish, pending steps are dropped.
+	~DuelExecutor() noexcept;
+
+	DuelExecutor(DuelExecutor const&) = delete;
+	auto operator=(DuelExecutor const&) -> DuelExecutor& = delete;
+
+	// Takes ownership of `duel` and schedules its `start`.
+	auto add(std::unique_ptr<IDuel> duel) noexcept -> DuelId;
+
+	// Stops running the duel, it is destroyed after its current step (if any)
+	// finishes, and its pending answers are dropped. Returns false if there is
+	// no such duel.
+	auto remove(DuelId id) noexcept -> bool;
+
+	// Schedules giving `answer` to the duel. Returns false if there is no such
+	// duel.
+	auto submit_answer(DuelId id, Answer answer) noexcept -> bool;
+
+	[[nodiscard]] auto metrics() const noexcept -> Metrics;
+
+	// Returns false if there is no such duel.
+	auto duel_metrics(DuelId id, DuelMetrics& metrics) const noexcept -> bool;
+
+	[[nodiscard]] auto worker_count() const noexcept -> size_t;
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> impl_;
+};
+
+} // namespace YGOpen::Server
+
+#endif // YGOPEN_SERVER_DUEL_EXECUTOR_HPP
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_SERVER_MSG_PIPELINE_HPP
+#define YGOPEN_SERVER_MSG_PIPELINE_HPP
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <ygopen/server/duel.hpp>
+
+namespace YGOpen::Server
+{
+
+// Encodes core messages on a thread of its own, so that the thread stepping
+// the core does not wait for messages to be encoded, broadcast or recorded.
+// Stands in for calling `IDuel::Options::process_cb` synchronously: the duel
+// pushes each buffer it gets from the core, as is, and the pipeline encodes
+// it with a `BasicEncodeContext` and gives every resulting message to each
+// consumer.
+//
+// Buffers go through a lock-free single-producer single-consumer ring; its
+// slots keep their memory, as do the encoded messages, so once warmed up
+// nothing is allocated per buffer.
+//
+// Ordering: consumers get messages in the order their buffers were pushed
+// and, for each message, are called in the order they were given. They are
+// only ever called from the pipeline's thread, never concurrently, and the
+// message is only valid during the call.
+//
+// Backpressure: at most `Options::capacity` buffers wait to be encoded, after
+// which `push` blocks until one is done (or `try_push` fails), so a slow
+// consumer slows down the core instead of growing memory without bound.
+//
+// NOTE: Only one thread may push or flush at any given time.
+class MsgPipeline
+{
+public:
+	using Msg = IDuel::Msg;
+	using Consumer = IDuel::ProcessCallback;
+
+	struct Options
+	{
+		// Buffers that can wait to be encoded, rounded up to a power of two.
+		size_t capacity = 64U;
+		// See `BasicEncodeContext`.
+		bool delta_queries = false;
+	};
+
+	// What was dropped while encoding, since the pipeline was created.
+	struct Stats
+	{
+		// Core messages the encoder does not know.
+		size_t unknown_msgs;
+		// Core messages that were empty or shorter than their contents.
+		size_t malformed_msgs;
+		// Buffers that ended in the middle of a message.
+		size_t truncated_buffers;
+	};
+
+	explicit MsgPipeline(std::vector<Consumer> consumers) noexcept;
+	MsgPipeline(std::vector<Consumer> consumers,
+	            Options const& options) noexcept;
+
+	// Delivers every buffer pushed so far before returning.
+	~MsgPipeline() noexcept;
+
+	MsgPipeline(MsgPipeline const&) = delete;
+	auto operator=(MsgPipeline const&) -> MsgPipeline& = delete;
+
+	// Queues a copy of a buffer as returned by `OCG_DuelGetMessage`, waiting
+	// for room if the pipeline is full.
+	auto push(uint8_t const* data, size_t size) noexcept -> void;
+
+	// Same as above, but returns false instead of waiting.
+	auto try_push(uint8_t const* data, size_t size) noexcept -> bool;
+
+	// Waits until every buffer pushed so far was delivered.
+	auto flush() noexcept -> void;
+
+	// Buffers pushed and not yet delivered.
+	[[nodiscard]] auto pending() const noexcept -> size_t;
+
+	// Exact once every buffer pushed was delivered (see `flush`).
+	[[nodiscard]] auto stats() const noexcept -> Stats;
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> impl_;
+};
+
+} // namespace YGOpen::Server
+
+#endif // YGOPEN_SERVER_MSG_PIPELINE_HPP
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2024, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_SERVER_SLIM_ENCODE_CONTEXT_HPP
+#define YGOPEN_SERVER_SLIM_ENCODE_CONTEXT_HPP
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <vector>
+#include <ygopen/client/frame.hpp>
+#include <ygopen/client/parse_event.hpp>
+#include <ygopen/client/value_types.hpp>
+#include <ygopen/codec/encode_common.hpp>
+#include <ygopen/duel/constants/controller.hpp>
+#include <ygopen/duel/constants/location.hpp>
+#include <ygopen/duel/constants/phase.hpp>
+#include <ygopen/proto/duel/data.hpp>
+#include <ygopen/proto/duel/msg.hpp>
+
+// Same as BasicEncodeContext but only keeping track of what the encoder needs:
+// the amount of cards in each pile and the amount of materials in each zone.
+// Card data is not stored at all, so queries are not applied nor stripped.
+
+namespace YGOpen::Server
+{
+
+namespace Detail
+{
+
+// Frame that mirrors BasicFrame's modifiers, but only counting cards.
+class CountFrame
+{
+public:
+	using PlaceType = YGOpen::Proto::Duel::Place;
+
+	[[nodiscard]] auto pile_size(YGOpen::Duel::Controller con,
+	                             YGOpen::Duel::Location loc) const noexcept
+		-> size_t
+	{
+		return piles_[con][Client::loc_index(loc)];
+	}
+
+	[[nodiscard]] auto materials(PlaceType const& place) const noexcept
+		-> size_t
+	{
+		return materials_[place.con()][zone_index_(place)];
+	}
+
+	auto card_add(PlaceType const& place) noexcept -> void
+	{
+		if(is_pile(place))
+			pile_(place)++;
+		else if(place.oseq() >= 0)
+			zone_materials_(place)++;
+	}
+
+	template<typename ForwardIt>
+	auto cards_add(ForwardIt first, ForwardIt last) noexcept -> void
+	{
+		for(; first != last; ++first)
+			card_add(*first);
+	}
+
+	auto card_remove(PlaceType const& place) noexcept -> void
+	{
+		if(is_pile(place))
+			pile_(place)--;
+		else if(place.oseq() >= 0)
+			zone_materials_(place)--;
+	}
+
+	auto card_move(PlaceType const& from, PlaceType const& to) noexcept -> void
+	{
+		// NOTE: A card moving between zones brings its materials along.
+		if(is_zone(from) && from.oseq() < 0 && is_zone(to) && to.oseq() < 0)
+		{
+			std::swap(zone_materials_(from), zone_materials_(to));
+			return;
+		}
+		card_remove(from);
+		card_add(to);
+	}
+
+	template<typename InputIt>
+	auto card_shuffle(InputIt previous, InputIt current,
+	                  size_t count) noexcept -> void
+	{
+		// NOTE: Same algorithm as BasicFrame, but swapping material counts.
+		constexpr size_t UPPER_BOUND =
+			Client::zone_seq_lim(YGOpen::Duel::LOCATION_MONSTER_ZONE);
+		std::array<uint32_t, UPPER_BOUND> seqs{};
+		for(size_t i = 0U; i < count; i++)
+			seqs[i] = (*previous++).seq();
+		for(size_t i = 0U; i < count; i++)
+		{
+			auto const& p = *current++;
+			if(is_empty(p))
+				continue;
+			auto other = p;
+			other.set_seq(seqs[i]);
+			std::swap(zone_materials_(other), zone_materials_(p));
+			auto const seq = p.seq();
+			for(size_t j = 0U; j < count; j++)
+			{
+				if(seqs[j] != seq)
+					continue;
+				seqs[j] = seqs[i];
+				break;
+			}
+			seqs[i] = seq;
+		}
+	}
+
+	auto card_swap(PlaceType const& a, PlaceType const& b) noexcept -> void
+	{
+		// NOTE: Only swapping zone cards changes counts, materials go along.
+		if(is_zone(a) && a.oseq() < 0 && is_zone(b) && b.oseq() < 0)
+			std::swap(zone_materials_(a), zone_materials_(b));
+	}
+
+	auto pile_resize(PlaceType const& place, size_t count) noexcept -> void
+	{
+		pile_(place) = static_cast<PileCount>(count);
+	}
+
+	auto pile_splice(PlaceType const& from, size_t count, PlaceType const& to,
+	                 [[maybe_unused]] bool reverse) noexcept -> void
+	{
+		pile_(from) -= static_cast<PileCount>(count);
+		pile_(to) += static_cast<PileCount>(count);
+	}
+
+	auto pile_swap(PlaceType const& a, PlaceType const& b) noexcept -> void
+	{
+		std::swap(pile_(a), pile_(b));
+	}
+
+	auto clear() noexcept -> void
+	{
+		piles_ = {};
+		materials_ = {};
+	}
+
+private:
+	using PileCount = uint16_t;
+	using MaterialCount = uint8_t;
+
+	static constexpr size_t PILE_COUNT = Client::Detail::PILE_LOCATIONS.size();
+	static constexpr size_t ZONE_COUNT = Client::Detail::ZONE_COUNT;
+
+	std::array<std::array<PileCount, PILE_COUNT>,
+	           YGOpen::Duel::CONTROLLER_ARRAY_SIZE>
+		piles_{};
+	std::array<std::array<MaterialCount, ZONE_COUNT>,
+	           YGOpen::Duel::CONTROLLER_ARRAY_SIZE>
+		materials_{};
+
+	auto pile_(PlaceType const& place) noexcept -> PileCount&
+	{
+		return piles_[place.con()][Client::loc_index(get_loc(place))];
+	}
+
+	auto zone_materials_(PlaceType const& place) noexcept -> MaterialCount&
+	{
+		return materials_[place.con()][zone_index_(place)];
+	}
+
+	static auto zone_index_(PlaceType const& place) noexcept -> size_t
+	{
+		return Client::zone_index(get_loc(place), place.seq());
+	}
+};
+
+// Accepts and discards everything given to it.
+struct Sink
+{
+	template<typename InputIt>
+	constexpr auto assign(InputIt /*first*/, InputIt /*last*/) noexcept -> void
+	{}
+
+	template<typename T>
+	constexpr auto push_back(T const& /*value*/) noexcept -> void
+	{}
+
+	constexpr auto pop_back() noexcept -> void {}
+};
+
+// Board that can be given to `Client::parse_event`.
+class CountBoard
+{
+public:
+	constexpr auto blocked_zones() noexcept -> Sink& { return sink_; }
+
+	constexpr auto chain_stack() noexcept -> Sink& { return sink_; }
+
+	constexpr auto frame() noexcept -> CountFrame& { return frame_; }
+
+	constexpr auto frame() const noexcept -> CountFrame const&
+	{
+		return frame_;
+	}
+
+	constexpr auto phase() noexcept -> YGOpen::Duel::Phase& { return phase_; }
+
+	constexpr auto turn() noexcept -> uint32_t& { return turn_; }
+
+	constexpr auto lp(YGOpen::Duel::Controller con) noexcept -> uint32_t&
+	{
+		return lp_[con];
+	}
+
+	constexpr auto turn_controller() noexcept -> YGOpen::Duel::Controller&
+	{
+		return turn_controller_;
+	}
+
+private:
+	CountFrame frame_;
+	Sink sink_;
+	std::array<uint32_t, YGOpen::Duel::CONTROLLER_ARRAY_SIZE> lp_{};
+	YGOpen::Duel::Phase phase_{};
+	uint32_t turn_{};
+	YGOpen::Duel::Controller turn_controller_{};
+};
+
+} // namespace Detail
+
+class SlimEncodeContext final : public YGOpen::Codec::IEncodeContext
+{
+public:
+	using Con = YGOpen::Codec::IEncodeContext::Con;
+	using Loc = YGOpen::Codec::IEncodeContext::Loc;
+	using Place = YGOpen::Codec::IEncodeContext::Place;
+
+	auto pile_size(Con con, Loc loc) const noexcept -> size_t override
+	{
+		return board_.frame().pile_size(con, loc);
+	}
+
+	auto get_match_win_reason() const noexcept -> uint32_t override
+	{
+		return match_win_reason_;
+	}
+
+	auto has_xyz_mat(Place const& p) const noexcept -> bool override
+	{
+		return board_.frame().materials(p) != 0U;
+	}
+
+	auto get_xyz_left(Place const& left) const noexcept -> Place override
+	{
+		Place place;
+		if(auto const it = find_left_(left); it != left_.cend())
+			YGOpen::Client::to_proto(it->second, place);
+		return place;
+	}
+
+	auto match_win_reason(uint32_t reason) noexcept -> void override
+	{
+		match_win_reason_ = reason;
+	}
+
+	auto xyz_mat_defer(Place const& place) noexcept -> void override
+	{
+		deferred_.emplace_back(place);
+	}
+
+	auto deferred_xyz_mat() const noexcept -> std::vector<Place> const& override
+	{
+		return deferred_;
+	}
+
+	auto clear_deferred_xyz_mat() noexcept -> void override
+	{
+		deferred_.clear();
+	}
+
+	auto xyz_left(Place const& left, Place const& from) noexcept
+		-> void override
+	{
+		if(auto it = find_left_(left); it != left_.end())
+			it->second = from;
+		else
+			left_.emplace_back(left, from);
+	}
+
+	auto parse(YGOpen::Proto::Duel::Msg& msg) noexcept -> bool override
+	{
+		if(msg.t_case() == YGOpen::Proto::Duel::Msg::kEvent)
+			YGOpen::Client::parse_event(board_, msg.event());
+		return true;
+	}
+
+	auto needs_queries() const noexcept -> bool override { return false; }
+
+private:
+	using LeftEntry =
+		std::pair<YGOpen::Client::PlaceValue, YGOpen::Client::PlaceValue>;
+
+	Detail::CountBoard board_;
+
+	uint32_t match_win_reason_{};
+	// NOTE: Flat and searched linearly. It holds one entry per card with
+	// materials that left the field, so it is always small.
+	std::vector<LeftEntry> left_;
+	std::vector<Place> deferred_;
+
+	auto find_left_(Place const& left) const noexcept
+		-> std::vector<LeftEntry>::const_iterator
+	{
+		YGOpen::Client::PlaceValue const key(left);
+		return std::find_if(left_.cbegin(), left_.cend(),
+		                    [&](LeftEntry const& e) { return e.first == key; });
+	}
+
+	auto find_left_(Place const& left) noexcept
+		-> std::vector<LeftEntry>::iterator
+	{
+		YGOpen::Client::PlaceValue const key(left);
+		return std::find_if(left_.begin(), left_.end(),
+		                    [&](LeftEntry const& e) { return e.first == key; });
+	}
+};
+
+} // namespace YGOpen::Server
+
+#endif // YGOPEN_SERVER_SLIM_ENCODE_CONTEXT_HPP
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2024, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include "ygopen/codec/coalesce.hpp"
+
+#include <google/protobuf/repeated_ptr_field.h>
+#include <limits>
+#include <ygopen/proto/duel/msg.hpp>
+
+namespace YGOpen::Codec
+{
+
+namespace
+{
+
+using Event = Proto::Duel::Msg::Event;
+
+// Adds `rhs` to `lhs` unless it would overflow.
+inline auto add_lp(uint32_t& lhs, uint32_t rhs) noexcept -> bool
+{
+	if(std::numeric_limits<uint32_t>::max() - lhs < rhs)
+		return false;
+	lhs += rhs;
+	return true;
+}
+
+auto merge_lp(Event::LP& lhs, Event::LP const& rhs) noexcept -> bool
+{
+	if(lhs.controller() != rhs.controller() || lhs.t_case() != rhs.t_case())
+		return false;
+	switch(lhs.t_case())
+	{
+	case Event::LP::kBecome:
+	{
+		lhs.set_become(rhs.become());
+		return true;
+	}
+	// NOTE: Subtracting clamps at 0, so subtracting twice is the same as
+	// subtracting the sum once.
+	case Event::LP::kDamage:
+	{
+		auto damage = lhs.damage();
+		if(!add_lp(damage, rhs.damage()))
+			return false;
+		lhs.set_damage(damage);
+		return true;
+	}
+	case Event::LP::kPay:
+	{
+		auto pay = lhs.pay();
+		if(!add_lp(pay, rhs.pay()))
+			return false;
+		lhs.set_pay(pay);
+		return true;
+	}
+	case Event::LP::kRecover:
+	{
+		auto recover = lhs.recover();
+		if(!add_lp(recover, rhs.recover()))
+			return false;
+		lhs.set_recover(recover);
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+// Merges `rhs` into `lhs` if parsing the result is the same as parsing both.
+auto merge(Event& lhs, Event const& rhs) noexcept -> bool
+{
+	if(lhs.t_case() != rhs.t_case())
+		return false;
+	switch(lhs.t_case())
+	{
+	case Event::kCard:
+	{
+		auto const& card = rhs.card();
+		if(lhs.card().t_case() != card.t_case() ||
+		   lhs.card().reason() != card.reason())
+			return false;
+		switch(card.t_case())
+		{
+		case Event::Card::kAdd:
+		case Event::Card::kMove:
+		case Event::Card::kRemove:
+		{
+			// NOTE: Appends the places/ops of `rhs` after the ones of `lhs`.
+			lhs.mutable_card()->MergeFrom(card);
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+	case Event::kPile:
+	{
+		auto const& pile = rhs.pile();
+		if(lhs.pile().t_case() != Event::Pile::kSplice ||
+		   pile.t_case() != Event::Pile::kSplice ||
+		   lhs.pile().reason() != pile.reason())
+			return false;
+		lhs.mutable_pile()->MergeFrom(pile);
+		return true;
+	}
+	case Event::kLp:
+	{
+		return merge_lp(*lhs.mutable_lp(), rhs.lp());
+	}
+	default:
+		return false;
+	}
+}
+
+} // namespace
+
+auto coalesce(
+	google::protobuf::RepeatedPtrField<Proto::Duel::Msg>& msgs) noexcept
+	-> size_t
+{
+	using Proto::Duel::Msg;
+	auto const size = msgs.size();
+	if(size == 0)
+		return 0U;
+	int last = 0;
+	for(int i = 1; i < size; i++)
+	{
+		auto& lhs = *msgs.Mutable(last);
+		auto const& rhs = msgs.Get(i);
+		if(lhs.t_case() == Msg::kEvent && rhs.t_case() == Msg::kEvent &&
+		   merge(*lhs.mutable_event(), rhs.event()))
+			continue;
+		msgs.SwapElements(++last, i);
+	}
+	auto const removed = size - (last + 1);
+	for(int i = 0; i < removed; i++)
+		msgs.RemoveLast();
+	return static_cast<size_t>(removed);
+}
+
+} // namespace YGOpen::Codec
@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include "ygopen/server/duel_executor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <ygopen/proto/duel/answer.hpp>
+
+namespace YGOpen::Server
+{
+
+namespace
+{
+
+// Executor (as an opaque pointer) and worker index of the calling thread, so
+// duels scheduled from a worker go to that worker's queue.
+thread_local void const* tl_executor = nullptr;
+thread_local size_t tl_worker = 0U;
+
+} // namespace
+
+struct DuelExecutor::Impl
+{
+	struct Entry
+	{
+		explicit Entry(std::unique_ptr<IDuel> d) noexcept : duel(std::move(d))
+		{}
+
+		std::unique_ptr<IDuel> duel;
+		// Guards everything below but the metrics.
+		std::mutex mutex;
+		std::deque<Answer> inbox;
+		bool start_pending{true};
+		bool queued{true}; // In a worker queue or being run.
+		// NOTE: Atomic so a running batch can stop without taking the lock.
+		std::atomic<bool> removed{false};
+		// NOTE: Only written by the worker running the duel.
+		std::atomic<uint64_t> steps{0U};
+		std::atomic<int64_t> last_ns{0};
+		std::atomic<int64_t> max_ns{0};
+		std::atomic<int64_t> total_ns{0};
+	};
+
+	using EntryPtr = std::shared_ptr<Entry>;
+
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<EntryPtr> queue;
+		std::thread thread;
+	};
+
+	Options options;
+	std::vector<std::unique_ptr<Worker>> workers;
+
+	mutable std::shared_mutex duels_mutex;
+	std::unordered_map<DuelId, EntryPtr> duels;
+	DuelId next_id{1U};
+
+	std::mutex sleep_mutex;
+	std::condition_variable wake;
+	std::atomic<bool> stopping{false};
+	// NOTE: Only changed while holding the lock of the queue changed.
+	std::atomic<size_t> queued{0U};
+	std::atomic<size_t> next_worker{0U};
+	std::atomic<uint64_t> steps{0U};
+	std::atomic<uint64_t> steals{0U};
+
+	explicit Impl(Options const& o) noexcept : options(o)
+	{
+		if(options.worker_count == 0U)
+		{
+			auto const hw = size_t{std::thread::hardware_concurrency()};
+			options.worker_count = std::max(size_t{1U}, hw);
+		}
+		options.batch_limit = std::max(size_t{1U}, options.batch_limit);
+		workers.reserve(options.worker_count);
+		for(size_t i = 0U; i < options.worker_count; i++)
+			workers.emplace_back(std::make_unique<Worker>());
+		for(size_t i = 0U; i < options.worker_count; i++)
+			workers[i]->thread = std::thread([this, i]() { run(i); });
+	}
+
+	~Impl() noexcept
+	{
+		{
+			std::scoped_lock lock(sleep_mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for(auto& w : workers)
+			w->thread.join();
+	}
+
+	auto find(DuelId id) const noexcept -> EntryPtr
+	{
+		std::shared_lock lock(duels_mutex);
+		auto const it = duels.find(id);
+		return (it != duels.end()) ? it->second : nullptr;
+	}
+
+	// Queues a duel whose `queued` flag was just set.
+	auto schedule(EntryPtr e) noexcept -> void
+	{
+		auto const n = workers.size();
+		auto const i = (tl_executor == this) ? tl_worker : next_worker++ % n;
+		{
+			auto& w = *workers[i];
+			std::scoped_lock lock(w.mutex);
+			w.queue.push_back(std::move(e));
+			queued++;
+		}
+		// NOTE: Locking makes sure a worker about to sleep sees the duel.
+		{
+			std::scoped_lock lock(sleep_mutex);
+		}
+		wake.notify_one();
+	}
+
+	// Takes the oldest duel of the worker's own queue, or else steals the
+	// newest duel of another worker's queue.
+	auto pop(size_t self) noexcept -> EntryPtr
+	{
+		{
+			auto& w = *workers[self];
+			std::scoped_lock lock(w.mutex);
+			if(!w.queue.empty())
+			{
+				auto e = std::move(w.queue.front());
+				w.queue.pop_front();
+				queued--;
+				return e;
+			}
+		}
+		auto const n = workers.size();
+		for(size_t k = 1U; k < n; k++)
+		{
+			auto& w = *workers[(self + k) % n];
+			std::scoped_lock lock(w.mutex);
+			if(w.queue.empty())
+				continue;
+			auto e = std::move(w.queue.back());
+			w.queue.pop_back();
+			queued--;
+			steals++;
+			return e;
+		}
+		return nullptr;
+	}
+
+	auto run(size_t self) noexcept -> void
+	{
+		tl_executor = this;
+		tl_worker = self;
+		while(!stopping)
+		{
+			if(auto e = pop(self); e != nullptr)
+			{
+				run_entry(std::move(e));
+				continue;
+			}
+			std::unique_lock lock(sleep_mutex);
+			wake.wait(lock, [this]() { return stopping || queued != 0U; });
+		}
+	}
+
+	template<typename F>
+	auto step(Entry& e, F&& f) noexcept -> void
+	{
+		using namespace std::chrono;
+		auto const begin = steady_clock::now();
+		f();
+		auto const elapsed = steady_clock::now() - begin;
+		auto const ns = duration_cast<nanoseconds>(elapsed).count();
+		e.last_ns.store(ns, std::memory_order_relaxed);
+		e.total_ns.store(e.total_ns.load(std::memory_order_relaxed) + ns,
+		                 std::memory_order_relaxed);
+		if(ns > e.max_ns.load(std::memory_order_relaxed))
+			e.max_ns.store(ns, std::memory_order_relaxed);
+		e.steps.fetch_add(1U, std::memory_order_relaxed);
+		steps++;
+	}
+
+	auto run_entry(EntryPtr e) noexcept -> void
+	{
+		bool start = false;
+		std::vector<Answer> batch;
+		{
+			std::scoped_lock lock(e->mutex);
+			if(e->removed)
+			{
+				e->queued = false;
+				return;
+			}
+			start = std::exchange(e->start_pending, false);
+			auto const count = std::min(e->inbox.size(), options.batch_limit);
+			batch.reserve(count);
+			for(size_t i = 0U; i < count; i++)
+			{
+				batch.emplace_back(std::move(e->inbox.front()));
+				e->inbox.pop_front();
+			}
+		}
+		// NOTE: A duel removed mid-batch only finishes its current step, and
+		// so does every duel once the executor is being destroyed.
+		auto const cancelled = [this, &e]() { return e->removed || stopping; };
+		if(start && !cancelled())
+			step(*e, [&e]() { e->duel->start(); });
+		for(auto const& answer : batch)
+		{
+			if(cancelled())
+				break;
+			step(*e, [&]() { e->duel->submit_answer(answer); });
+		}
+		bool reschedule = false;
+		{
+			std::scoped_lock lock(e->mutex);
+			reschedule = !cancelled() && !e->inbox.empty();
+			e->queued = reschedule;
+		}
+		// NOTE: Goes to the back of this worker's queue, behind the duels
+		// that were waiting.
+		if(reschedule)
+			schedule(std::move(e));
+	}
+};
+
+DuelExecutor::DuelExecutor() noexcept : DuelExecutor(Options{}) {}
+
+DuelExecutor::DuelExecutor(Options const& options) noexcept
+	: impl_(std::make_unique<Impl>(options))
+{}
+
+DuelExecutor::~DuelExecutor() noexcept = default;
+
+auto DuelExecutor::add(std::unique_ptr<IDuel> duel) noexcept -> DuelId
+{
+	auto e = std::make_shared<Impl::Entry>(std::move(duel));
+	DuelId id = 0U;
+	{
+		std::scoped_lock lock(impl_->duels_mutex);
+		id = impl_->next_id++;
+		impl_->duels.emplace(id, e);
+	}
+	impl_->schedule(std::move(e));
+	return id;
+}
+
+auto DuelExecutor::remove(DuelId id) noexcept -> bool
+{
+	Impl::EntryPtr e;
+	{
+		std::scoped_lock lock(impl_->duels_mutex);
+		auto const it = impl_->duels.find(id);
+		if(it == impl_->duels.end())
+			return false;
+		e = std::move(it->second);
+		impl_->duels.erase(it);
+	}
+	std::scoped_lock lock(e->mutex);
+	e->removed = true;
+	e->inbox.clear();
+	return true;
+}
+
+auto DuelExecutor::submit_answer(DuelId id, Answer answer) noexcept -> bool
+{
+	auto e = impl_->find(id);
+	if(e == nullptr)
+		return false;
+	bool schedule = false;
+	{
+		std::scoped_lock lock(e->mutex);
+		if(e->removed)
+			return false;
+		e->inbox.emplace_back(std::move(answer));
+		schedule = !std::exchange(e->queued, true);
+	}
+	if(schedule)
+		impl_->schedule(std::move(e));
+	return true;
+}
+
+auto DuelExecutor::metrics() const noexcept -> Metrics
+{
+	Metrics m{};
+	m.worker_queue_depths.reserve(impl_->workers.size());
+	for(auto const& w : impl_->workers)
+	{
+		std::scoped_lock lock(w->mutex);
+		m.worker_queue_depths.push_back(w->queue.size());
+		m.queue_depth += w->queue.size();
+	}
+	{
+		std::shared_lock lock(impl_->duels_mutex);
+		m.duel_count = impl_->duels.size();
+	}
+	m.steps = impl_->steps;
+	m.steals = impl_->steals;
+	return m;
+}
+
+auto DuelExecutor::duel_metrics(DuelId id, DuelMetrics& metrics) const noexcept
+	-> bool
+{
+	auto const e = impl_->find(id);
+	if(e == nullptr)
+		return false;
+	{
+		std::scoped_lock lock(e->mutex);
+		metrics.pending_answers = e->inbox.size();
+	}
+	using std::chrono::nanoseconds;
+	auto const load = [](auto const& v)
+	{ return v.load(std::memory_order_relaxed); };
+	metrics.steps = load(e->steps);
+	metrics.last_step = nanoseconds(load(e->last_ns));
+	metrics.max_step = nanoseconds(load(e->max_ns));
+	metrics.total_step = nanoseconds(load(e->total_ns));
+	return true;
+}
+
+auto DuelExecutor::worker_count() const noexcept -> size_t
+{
+	return impl_->workers.size();
+}
+
+} // namespace YGOpen::Server
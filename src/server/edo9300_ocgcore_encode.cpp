@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include "ygopen/codec/edo9300_ocgcore_encode.hpp"
+
+#include <ygopen/server/basic_encode_context.hpp>
+#include <ygopen/server/slim_encode_context.hpp>
+
+// Instantiates the encoder for the server's own contexts, so calls into them
+// are resolved statically. Lives here so the codec does not depend on the
+// server (nor on the client headers the contexts use).
+#include <ygopen/codec/edo9300_ocgcore_encode.inl>
+
+namespace YGOpen::Codec::Edo9300::OCGCore
+{
+
+#define INSTANTIATE(Context)                                                  \
+	template auto encode_one<Context>(google::protobuf::Arena&, Context&,     \
+	                                  uint8_t const*) noexcept                \
+		-> EncodeOneResult;                                                   \
+	template auto encode_all<Context>(                                        \
+		Context&, uint8_t const*, size_t,                                     \
+		google::protobuf::RepeatedPtrField<Proto::Duel::Msg>&) noexcept       \
+		-> EncodeAllResult;
+INSTANTIATE(Server::BasicEncodeContext)
+INSTANTIATE(Server::SlimEncodeContext)
+#undef INSTANTIATE
+
+} // namespace YGOpen::Codec::Edo9300::OCGCore
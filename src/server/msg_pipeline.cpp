@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include "ygopen/server/msg_pipeline.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <google/protobuf/repeated_ptr_field.h>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <ygopen/codec/edo9300_ocgcore_encode.hpp>
+#include <ygopen/detail/spsc_ring.hpp>
+#include <ygopen/proto/duel/msg.hpp>
+#include <ygopen/server/basic_encode_context.hpp>
+
+namespace YGOpen::Server
+{
+
+struct MsgPipeline::Impl
+{
+	using Buffer = std::vector<uint8_t>;
+
+	std::vector<Consumer> consumers;
+	Detail::SpscRing<Buffer> ring;
+	BasicEncodeContext context;
+	google::protobuf::RepeatedPtrField<Msg> out;
+
+	// Only used to sleep when the ring is empty (consumer) or full (producer).
+	std::mutex mutex;
+	std::condition_variable consumer_wake;
+	std::condition_variable producer_wake;
+	std::atomic<bool> consumer_sleeping{false};
+	std::atomic<bool> producer_sleeping{false};
+	std::atomic<bool> stopping{false};
+
+	// NOTE: Only written by the pipeline's thread, read from anywhere.
+	std::atomic<size_t> unknown_msgs{0U};
+	std::atomic<size_t> malformed_msgs{0U};
+	std::atomic<size_t> truncated_buffers{0U};
+
+	std::thread thread;
+
+	Impl(std::vector<Consumer> c, Options const& options) noexcept
+		: consumers(std::move(c))
+		, ring(options.capacity)
+		, context(options.delta_queries)
+		, thread([this]() { run(); })
+	{}
+
+	~Impl() noexcept
+	{
+		{
+			std::scoped_lock lock(mutex);
+			stopping = true;
+		}
+		consumer_wake.notify_one();
+		thread.join();
+	}
+
+	// NOTE: The fences pair up a side announcing it is going to sleep with
+	// the other side publishing progress, so at least one of them sees the
+	// other and no wake up is lost.
+	template<typename Pred>
+	auto sleep(std::atomic<bool>& sleeping, std::condition_variable& cv,
+	           Pred&& pred) noexcept -> void
+	{
+		std::unique_lock lock(mutex);
+		sleeping.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		cv.wait(lock, pred);
+		sleeping.store(false, std::memory_order_relaxed);
+	}
+
+	auto wake(std::atomic<bool> const& sleeping,
+	          std::condition_variable& cv) noexcept -> void
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(!sleeping.load(std::memory_order_relaxed))
+			return;
+		{
+			std::scoped_lock lock(mutex);
+		}
+		cv.notify_one();
+	}
+
+	auto run() noexcept -> void
+	{
+		for(;;)
+		{
+			if(auto* buffer = ring.front(); buffer != nullptr)
+			{
+				deliver(*buffer);
+				ring.pop();
+				wake(producer_sleeping, producer_wake);
+				continue;
+			}
+			// NOTE: Buffers pushed before stopping are visible once it is.
+			if(stopping && ring.front() == nullptr)
+				return;
+			sleep(consumer_sleeping, consumer_wake,
+			      [this]() { return stopping || ring.front() != nullptr; });
+		}
+	}
+
+	auto deliver(Buffer const& buffer) noexcept -> void
+	{
+		using Codec::Edo9300::OCGCore::encode_all;
+		// NOTE: Cleared messages are kept around and reused by `encode_all`.
+		out.Clear();
+		auto const result =
+			encode_all(context, buffer.data(), buffer.size(), out);
+		auto add = [](std::atomic<size_t>& counter, size_t n)
+		{
+			if(n != 0U)
+				counter.fetch_add(n, std::memory_order_relaxed);
+		};
+		add(unknown_msgs, result.unknown_count);
+		add(malformed_msgs, result.malformed_count);
+		add(truncated_buffers, result.bytes_read != buffer.size() ? 1U : 0U);
+		for(auto const& msg : out)
+			for(auto const& consumer : consumers)
+				consumer(msg);
+	}
+
+	auto try_push(uint8_t const* data, size_t size) noexcept -> bool
+	{
+		auto* slot = ring.back();
+		if(slot == nullptr)
+			return false;
+		slot->assign(data, data + size);
+		ring.push();
+		wake(consumer_sleeping, consumer_wake);
+		return true;
+	}
+};
+
+MsgPipeline::MsgPipeline(std::vector<Consumer> consumers) noexcept
+	: MsgPipeline(std::move(consumers), Options{})
+{}
+
+MsgPipeline::MsgPipeline(std::vector<Consumer> consumers,
+                         Options const& options) noexcept
+	: impl_(std::make_unique<Impl>(std::move(consumers), options))
+{}
+
+MsgPipeline::~MsgPipeline() noexcept = default;
+
+auto MsgPipeline::push(uint8_t const* data, size_t size) noexcept -> void
+{
+	auto& impl = *impl_;
+	while(!impl.try_push(data, size))
+		impl.sleep(impl.producer_sleeping, impl.producer_wake,
+		           [&impl]() { return impl.ring.back() != nullptr; });
+}
+
+auto MsgPipeline::try_push(uint8_t const* data, size_t size) noexcept -> bool
+{
+	return impl_->try_push(data, size);
+}
+
+auto MsgPipeline::flush() noexcept -> void
+{
+	auto& impl = *impl_;
+	if(impl.ring.size() == 0U)
+		return;
+	impl.sleep(impl.producer_sleeping, impl.producer_wake,
+	           [&impl]() { return impl.ring.size() == 0U; });
+}
+
+auto MsgPipeline::pending() const noexcept -> size_t
+{
+	return impl_->ring.size();
+}
+
+auto MsgPipeline::stats() const noexcept -> Stats
+{
+	auto const& impl = *impl_;
+	return {impl.unknown_msgs.load(std::memory_order_relaxed),
+	        impl.malformed_msgs.load(std::memory_order_relaxed),
+	        impl.truncated_buffers.load(std::memory_order_relaxed)};
+}
+
+} // namespace YGOpen::Server
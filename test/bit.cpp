@@ -20,6 +20,15 @@ TEST(BitOps, PopcntWorks)
 	ASSERT_EQ(popcnt(0b1010'0101U), 4);
 }
 
+TEST(BitOps, CtzWorks)
+{
+	ASSERT_EQ(ctz(0U), 32);
+	ASSERT_EQ(ctz(uint64_t{}), 64);
+	ASSERT_EQ(ctz(1U), 0);
+	ASSERT_EQ(ctz(0b1010'0000U), 5);
+	ASSERT_EQ(ctz(uint64_t{1} << 40U), 40);
+}
+
 TEST(BitOps, ChooseLWorks)
 {
 	ASSERT_EQ(choosel(0U, 0b1111'1111U), 0b0000'0000U);
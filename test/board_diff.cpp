@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include <ygopen/client/board.hpp>
+#include <ygopen/client/board_diff.hpp>
+#include <ygopen/client/card.hpp>
+#include <ygopen/client/default_card_traits.hpp>
+#include <ygopen/client/frame_hashed.hpp>
+#include <ygopen/client/parse_event.hpp>
+#include <ygopen/client/value_types.hpp>
+#include <ygopen/duel/constants/phase.hpp>
+
+#include "frame_helpers.hpp"
+
+namespace
+{
+
+using namespace YGOpen::Client;
+using namespace YGOpen::Duel;
+using namespace YGOpen::Proto::Duel;
+using namespace YGOpen::Client::Test;
+
+using CardType = BasicCard<DefaultCardTraits>;
+
+using BoardType = BasicBoard<TestBoardTraits<HashedFrame<CardType>>>;
+using Msgs = google::protobuf::RepeatedPtrField<Msg>;
+
+auto pile(Controller con, Location loc, uint32_t seq) noexcept -> PlaceValue
+{
+	return {con, loc, seq, OSEQ_NONE};
+}
+
+auto apply(BoardType& b, Msgs const& msgs) noexcept -> void
+{
+	for(auto const& msg : msgs)
+	{
+		if(msg.has_event())
+			parse_event(b, msg.event());
+		for(auto const& query : msg.queries())
+			static_cast<void>(parse_query(b.frame(), query));
+	}
+}
+
+// Does random, valid, changes to a board.
+class Scrambler
+{
+public:
+	explicit Scrambler(uint32_t seed) noexcept : rng_(seed) {}
+
+	auto operator()(BoardType& b, size_t count) noexcept -> void
+	{
+		for(size_t i = 0U; i < count; i++)
+			step_(b);
+	}
+
+private:
+	std::mt19937 rng_;
+
+	auto below_(size_t n) noexcept -> uint32_t
+	{
+		return static_cast<uint32_t>(
+			std::uniform_int_distribution<size_t>(0U, n - 1U)(rng_));
+	}
+
+	auto code_() noexcept -> uint32_t { return below_(4U); }
+
+	auto con_() noexcept -> Controller
+	{
+		return static_cast<Controller>(below_(2U));
+	}
+
+	auto random_pile_(BoardType const& b, bool inserting) noexcept
+		-> PlaceValue
+	{
+		auto const loc = Detail::PILE_LOCATIONS[below_(5U)];
+		auto const con = con_();
+		auto const size = b.frame().pile(con, loc).size();
+		if(!inserting && size == 0U)
+			return {};
+		return pile(con, loc, below_(size + (inserting ? 1U : 0U)));
+	}
+
+	auto random_zone_(BoardType const& b, bool occupied) noexcept
+		-> PlaceValue
+	{
+		auto const loc = Detail::ZONE_LOCATIONS[below_(5U)];
+		auto const con = con_();
+		auto const seq = below_(zone_seq_lim(loc));
+		auto const& z = b.frame().zone(con, loc, seq);
+		if(occupied != (z.card != nullptr))
+			return {};
+		if(!occupied && !z.materials.empty())
+			return {};
+		return {con, loc, seq, OSEQ_NONE};
+	}
+
+	auto random_card_(BoardType const& b) noexcept -> PlaceValue
+	{
+		std::vector<PlaceValue> places;
+		Detail::for_each_card(b.frame(), [&](PlaceValue p, CardType const&)
+		                      { places.push_back(p); });
+		if(places.empty())
+			return {};
+		return places[below_(places.size())];
+	}
+
+	auto step_(BoardType& b) noexcept -> void
+	{
+		auto& f = b.frame();
+		switch(below_(10U))
+		{
+		case 0U:
+		case 1U:
+		{
+			add_card(b.frame(), random_pile_(b, true), code_());
+			break;
+		}
+		case 2U:
+		{
+			if(auto const z = random_zone_(b, false); !is_empty(z))
+				add_card(b.frame(), z, code_());
+			break;
+		}
+		case 3U:
+		{
+			auto z = random_zone_(b, true);
+			if(is_empty(z))
+				break;
+			z.set_oseq(static_cast<int32_t>(
+				below_(f.zone(z).materials.size() + 1U)));
+			add_card(b.frame(), z, code_());
+			break;
+		}
+		case 4U:
+		{
+			if(auto const p = random_card_(b); !is_empty(p))
+				f.card_remove(p);
+			break;
+		}
+		case 5U:
+		case 6U:
+		{
+			auto const from = random_card_(b);
+			if(is_empty(from))
+				break;
+			bool const zone_card = !is_pile(from) && from.oseq() < 0;
+			PlaceValue to = random_pile_(b, true);
+			if(zone_card && below_(2U) == 0U)
+				to = random_zone_(b, false);
+			if(is_empty(to))
+				break;
+			if(is_pile(from) && is_pile(to) && from.con() == to.con() &&
+			   from.loc() == to.loc() && to.seq() == f.pile(to).size())
+				break;
+			f.card_move(from, to);
+			break;
+		}
+		case 7U:
+		{
+			if(auto const p = random_card_(b); !is_empty(p))
+				set_code(b.frame(), p, code_());
+			break;
+		}
+		case 8U:
+		{
+			b.lp(con_()) = below_(8001U);
+			b.phase() = static_cast<Phase>(1U << below_(4U));
+			break;
+		}
+		default:
+		{
+			auto& chains = b.chain_stack();
+			if(!chains.empty() && below_(2U) == 0U)
+				chains.pop_back();
+			else
+				chains.push_back(ChainValue{{}, {}, {code_(), 0U}});
+			break;
+		}
+		}
+	}
+};
+
+TEST(BoardDiffTest, SameBoardsNeedNothing)
+{
+	BoardType a;
+	BoardType b;
+	add_card(a.frame(), pile(CONTROLLER_0, LOCATION_HAND, 0U), 1U);
+	add_card(b.frame(), pile(CONTROLLER_0, LOCATION_HAND, 0U), 1U);
+	EXPECT_TRUE(diff(a, b).empty());
+}
+
+TEST(BoardDiffTest, CardsAreMovedInsteadOfReadded)
+{
+	BoardType a;
+	BoardType b;
+	add_card(a.frame(), pile(CONTROLLER_0, LOCATION_HAND, 0U), 1U);
+	add_card(a.frame(), pile(CONTROLLER_0, LOCATION_HAND, 1U), 2U);
+	add_card(b.frame(), pile(CONTROLLER_0, LOCATION_HAND, 0U), 1U);
+	add_card(b.frame(), at(MZONE, 2U), 2U);
+	auto const msgs = diff(a, b);
+	ASSERT_EQ(msgs.size(), 1);
+	ASSERT_TRUE(msgs[0].event().card().has_move());
+	EXPECT_EQ(msgs[0].event().card().move().ops_size(), 1);
+	EXPECT_EQ(msgs[0].queries_size(), 0);
+}
+
+TEST(BoardDiffTest, RunsOfCardsAreSpliced)
+{
+	BoardType a;
+	BoardType b;
+	for(uint32_t i = 0U; i < 5U; i++)
+		add_card(a.frame(), pile(CONTROLLER_1, LOCATION_MAIN_DECK, i), i + 1U);
+	for(uint32_t i = 0U; i < 3U; i++)
+		add_card(b.frame(), pile(CONTROLLER_1, LOCATION_MAIN_DECK, i), i + 1U);
+	for(uint32_t i = 0U; i < 2U; i++)
+		add_card(b.frame(), pile(CONTROLLER_1, LOCATION_HAND, i), i + 4U);
+	auto const msgs = diff(a, b);
+	ASSERT_EQ(msgs.size(), 1);
+	ASSERT_TRUE(msgs[0].event().pile().has_splice());
+	EXPECT_EQ(msgs[0].event().pile().splice().ops_size(), 1);
+	apply(a, msgs);
+	EXPECT_EQ(layout(a.frame()), layout(b.frame()));
+}
+
+TEST(BoardDiffTest, NewFaceDownCardsResizePiles)
+{
+	BoardType a;
+	BoardType b;
+	b.frame().pile_resize(pile(CONTROLLER_0, LOCATION_MAIN_DECK, 0U), 40U);
+	auto const msgs = diff(a, b);
+	ASSERT_EQ(msgs.size(), 1);
+	EXPECT_EQ(msgs[0].event().board().exchange().resize().ops_size(), 1);
+	apply(a, msgs);
+	EXPECT_EQ(a.state_hash(), b.state_hash());
+}
+
+TEST(BoardDiffTest, ResizesAreGroupedByController)
+{
+	BoardType a;
+	BoardType b;
+	b.frame().pile_resize(pile(CONTROLLER_0, LOCATION_MAIN_DECK, 0U), 40U);
+	b.frame().pile_resize(pile(CONTROLLER_0, LOCATION_EXTRA_DECK, 0U), 15U);
+	b.frame().pile_resize(pile(CONTROLLER_1, LOCATION_MAIN_DECK, 0U), 40U);
+	auto const msgs = diff(a, b);
+	ASSERT_EQ(msgs.size(), 2);
+	for(auto const& msg : msgs)
+	{
+		auto const& exchange = msg.event().board().exchange();
+		for(auto const& op : exchange.resize().ops())
+			EXPECT_EQ(op.place().con(), exchange.con());
+	}
+	EXPECT_EQ(msgs[0].event().board().exchange().resize().ops_size(), 2);
+	apply(a, msgs);
+	EXPECT_EQ(a.state_hash(), b.state_hash());
+}
+
+TEST(BoardDiffTest, RandomBoardsConverge)
+{
+	for(uint32_t seed = 0U; seed < 200U; seed++)
+	{
+		BoardType a;
+		BoardType b;
+		Scrambler scramble_a(seed);
+		Scrambler scramble_b(seed);
+		scramble_a(a, 60U);
+		scramble_b(b, 60U);
+		scramble_b(b, 1U + seed % 30U);
+		b.turn() = a.turn() + seed % 3U;
+		apply(a, diff(a, b));
+		EXPECT_EQ(layout(a.frame()), layout(b.frame())) << "seed " << seed;
+		EXPECT_EQ(a.state_hash(), b.state_hash()) << "seed " << seed;
+		EXPECT_TRUE(diff(a, b).empty()) << "seed " << seed;
+	}
+}
+
+} // namespace
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include <google/protobuf/repeated_ptr_field.h>
+#include <gtest/gtest.h>
+#include <ygopen/codec/coalesce.hpp>
+#include <ygopen/proto/duel/msg.hpp>
+
+namespace
+{
+
+using namespace YGOpen::Proto::Duel;
+
+class CoalesceTest : public ::testing::Test
+{
+protected:
+	google::protobuf::RepeatedPtrField<Msg> msgs;
+
+	auto add_move(uint64_t reason, uint32_t seq) noexcept -> void
+	{
+		auto& card = *msgs.Add()->mutable_event()->mutable_card();
+		card.set_reason(reason);
+		auto& op = *card.mutable_move()->add_ops();
+		op.mutable_old_place()->set_seq(seq);
+		op.mutable_new_place()->set_seq(seq + 1U);
+	}
+
+	auto add_damage(int32_t con, uint32_t damage) noexcept -> void
+	{
+		auto& lp = *msgs.Add()->mutable_event()->mutable_lp();
+		lp.set_controller(con);
+		lp.set_damage(damage);
+	}
+};
+
+TEST_F(CoalesceTest, EmptyWorks)
+{
+	EXPECT_EQ(YGOpen::Codec::coalesce(msgs), 0U);
+	EXPECT_TRUE(msgs.empty());
+}
+
+TEST_F(CoalesceTest, MovesAreMergedInOrder)
+{
+	add_move(1U, 0U);
+	add_move(1U, 1U);
+	add_move(1U, 2U);
+	EXPECT_EQ(YGOpen::Codec::coalesce(msgs), 2U);
+	ASSERT_EQ(msgs.size(), 1);
+	auto const& ops = msgs.Get(0).event().card().move().ops();
+	ASSERT_EQ(ops.size(), 3);
+	for(int i = 0; i < ops.size(); i++)
+		EXPECT_EQ(ops.Get(i).old_place().seq(), static_cast<uint32_t>(i));
+}
+
+TEST_F(CoalesceTest, DifferentEventsAreKeptApart)
+{
+	add_move(1U, 0U);
+	add_move(2U, 1U); // Different reason.
+	add_damage(0, 100U);
+	msgs.Add()->mutable_event()->set_next_phase(1U);
+	add_move(2U, 2U);
+	EXPECT_EQ(YGOpen::Codec::coalesce(msgs), 0U);
+	EXPECT_EQ(msgs.size(), 5);
+}
+
+TEST_F(CoalesceTest, LPChangesAreAdded)
+{
+	add_damage(0, 100U);
+	add_damage(0, 200U);
+	add_damage(1, 300U);
+	add_damage(1, UINT32_MAX); // Would overflow.
+	EXPECT_EQ(YGOpen::Codec::coalesce(msgs), 1U);
+	ASSERT_EQ(msgs.size(), 3);
+	EXPECT_EQ(msgs.Get(0).event().lp().damage(), 300U);
+	EXPECT_EQ(msgs.Get(1).event().lp().damage(), 300U);
+	EXPECT_EQ(msgs.Get(2).event().lp().damage(), UINT32_MAX);
+}
+
+} // namespace
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include <gtest/gtest.h>
+#include <memory>
+#include <utility>
+#include <ygopen/client/column_card.hpp>
+#include <ygopen/client/default_card_traits.hpp>
+#include <ygopen/client/parse_query.hpp>
+
+namespace
+{
+
+using namespace YGOpen::Duel;
+
+using FrameType =
+	YGOpen::Client::ColumnFrame<YGOpen::Client::DefaultCardTraits>;
+
+constexpr auto OSEQ_INVALID = YGOpen::Proto::Duel::OSEQ_INVALID;
+
+auto make_place(Location loc, uint32_t seq) noexcept
+	-> YGOpen::Proto::Duel::Place
+{
+	YGOpen::Proto::Duel::Place place;
+	place.set_loc(loc);
+	place.set_seq(seq);
+	place.set_oseq(OSEQ_INVALID);
+	return place;
+}
+
+class ColumnCardTest : public ::testing::Test
+{
+protected:
+	FrameType frame;
+};
+
+TEST_F(ColumnCardTest, ParseQueryWritesIntoColumns)
+{
+	auto const& columns = frame.builder().columns();
+	auto const place = make_place(LOCATION_MONSTER_ZONE, 3U);
+	auto& card = frame.card_add(place);
+	YGOpen::Proto::Duel::Msg::Query query;
+	*query.mutable_place() = place;
+	query.mutable_data()->mutable_code()->set_value(1234U);
+	query.mutable_data()->mutable_atk()->set_value(2500);
+	query.mutable_data()->mutable_is_public()->set_value(true);
+	static_cast<void>(YGOpen::Client::parse_query(frame, query));
+	auto const h = card.handle();
+	EXPECT_EQ(card.code(), 1234U);
+	EXPECT_EQ(columns.code(h), 1234U);
+	EXPECT_EQ(columns.atk_column()[h], 2500);
+	EXPECT_TRUE(columns.is_public_column()[h]);
+	EXPECT_EQ(columns.def(h), 0);
+}
+
+TEST_F(ColumnCardTest, HandlesAreStableAndReused)
+{
+	auto const& columns = frame.builder().columns();
+	auto const hand = make_place(LOCATION_HAND, 0U);
+	auto const zone = make_place(LOCATION_MONSTER_ZONE, 0U);
+	auto& a = frame.card_add(hand);
+	a.code() = 1U;
+	auto const a_handle = a.handle();
+	auto& b = frame.card_add(hand);
+	b.code() = 2U;
+	EXPECT_NE(b.handle(), a_handle);
+	// Moving a card around does not change its handle nor its values.
+	auto& moved = frame.card_move(make_place(LOCATION_HAND, 1U), zone);
+	EXPECT_EQ(moved.handle(), a_handle);
+	EXPECT_EQ(columns.code(a_handle), 1U);
+	frame.card_remove(zone);
+	EXPECT_FALSE(columns.is_alive(a_handle));
+	// A new card gets the freed handle back, with default values.
+	auto& c = frame.card_add(hand);
+	EXPECT_EQ(c.handle(), a_handle);
+	EXPECT_EQ(c.code(), 0U);
+	EXPECT_EQ(columns.size(), 2U);
+}
+
+TEST_F(ColumnCardTest, ColumnsSurviveGrowth)
+{
+	auto const& columns = frame.builder().columns();
+	auto const place = make_place(LOCATION_MAIN_DECK, 0U);
+	frame.pile_resize(place, 200U);
+	auto const& pile = frame.pile(place);
+	for(size_t i = 0U; i < pile.size(); i++)
+		pile[i]->code() = static_cast<uint32_t>(i);
+	frame.pile_resize(place, 400U);
+	for(size_t i = 0U; i < 200U; i++)
+		EXPECT_EQ(columns.code(pile[i]->handle()), i);
+	frame.clear();
+	for(size_t h = 0U; h < columns.size(); h++)
+		EXPECT_FALSE(columns.is_alive(static_cast<uint32_t>(h)));
+}
+
+TEST_F(ColumnCardTest, MovedFramesKeepTheirColumns)
+{
+	auto const hand = make_place(LOCATION_HAND, 0U);
+	auto source = std::make_unique<FrameType>();
+	source->card_add(hand).code() = 42U;
+	FrameType moved(std::move(*source));
+	source.reset();
+	EXPECT_EQ(moved.card(hand).code(), 42U);
+	EXPECT_EQ(moved.builder().columns().size(), 1U);
+	moved.card_add(hand).code() = 43U;
+	EXPECT_EQ(moved.card(make_place(LOCATION_HAND, 1U)).code(), 42U);
+}
+
+} // namespace
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include <gtest/gtest.h>
+#include <vector>
+#include <ygopen/proto/duel/answer.hpp>
+#include <ygopen/server/duel.hpp>
+
+namespace
+{
+
+using namespace YGOpen::Server;
+
+// Records the codes of the cards it is given, and nothing else.
+class RecordingDuel final : public IDuel
+{
+public:
+	std::vector<uint32_t> codes;
+
+	auto card_add(YGOpen::Proto::Duel::Place const& place, uint8_t owner_team,
+	              uint8_t owner_duelist, uint32_t code,
+	              uint32_t pos) noexcept -> void override
+	{
+		EXPECT_EQ(place.seq(), codes.size());
+		EXPECT_EQ(owner_team, 1U);
+		EXPECT_EQ(owner_duelist, 2U);
+		EXPECT_EQ(pos, 4U);
+		codes.push_back(code);
+	}
+
+	auto start() noexcept -> void override {}
+
+	auto submit_answer(Answer const& /*answer*/) noexcept -> void override {}
+};
+
+TEST(DuelTest, CardsAddDefaultsToCardAddInOrder)
+{
+	std::vector<IDuel::CardSpec> specs(3U);
+	for(uint32_t i = 0U; i < specs.size(); i++)
+	{
+		auto& s = specs[i];
+		s.place.set_seq(i);
+		s.owner_team = 1U;
+		s.owner_duelist = 2U;
+		s.code = 100U + i;
+		s.pos = 4U;
+	}
+	RecordingDuel duel;
+	IDuel& iduel = duel;
+	iduel.cards_add(specs.data(), specs.size());
+	EXPECT_EQ(duel.codes, (std::vector<uint32_t>{100U, 101U, 102U}));
+	iduel.cards_add(specs.data(), 0U);
+	EXPECT_EQ(duel.codes.size(), 3U);
+}
+
+} // namespace
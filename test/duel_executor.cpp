@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <ygopen/proto/duel/answer.hpp>
+#include <ygopen/server/duel_executor.hpp>
+
+namespace
+{
+
+using namespace YGOpen::Server;
+using Answer = DuelExecutor::Answer;
+
+// Records the answers it is given, failing if it is ever stepped from two
+// threads at once.
+class FakeDuel final : public IDuel
+{
+public:
+	struct Log
+	{
+		std::mutex mutex;
+		bool started{false};
+		bool overlapped{false};
+		std::vector<uint32_t> answers;
+		std::atomic<size_t> steps{0U};
+	};
+
+	using OnAnswer = std::function<auto(uint32_t)->void>;
+
+	explicit FakeDuel(std::shared_ptr<Log> log,
+	                  OnAnswer on_answer = nullptr) noexcept
+		: log_(std::move(log)), on_answer_(std::move(on_answer))
+	{}
+
+	auto card_add(YGOpen::Proto::Duel::Place const& /*place*/,
+	              uint8_t /*owner_team*/, uint8_t /*owner_duelist*/,
+	              uint32_t /*code*/, uint32_t /*pos*/) noexcept -> void override
+	{}
+
+	auto start() noexcept -> void override
+	{
+		step([this]() { log_->started = true; });
+	}
+
+	auto submit_answer(Answer const& answer) noexcept -> void override
+	{
+		auto const n = answer.select_number();
+		step([&]() { log_->answers.push_back(n); });
+		if(on_answer_)
+			on_answer_(n);
+	}
+
+private:
+	std::shared_ptr<Log> log_;
+	OnAnswer on_answer_;
+	std::atomic<bool> in_step_{false};
+
+	template<typename F>
+	auto step(F&& f) noexcept -> void
+	{
+		if(in_step_.exchange(true))
+			log_->overlapped = true;
+		std::this_thread::yield();
+		{
+			std::scoped_lock lock(log_->mutex);
+			f();
+		}
+		in_step_ = false;
+		log_->steps++;
+	}
+};
+
+auto make_answer(uint32_t n) noexcept -> Answer
+{
+	Answer answer;
+	answer.set_select_number(n);
+	return answer;
+}
+
+template<typename F>
+auto wait_for(F&& f) noexcept -> bool
+{
+	auto const deadline =
+		std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while(!f())
+	{
+		if(std::chrono::steady_clock::now() > deadline)
+			return false;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return true;
+}
+
+TEST(DuelExecutorTest, StepsOfADuelRunInOrderAndOneAtATime)
+{
+	constexpr size_t DUEL_COUNT = 32U;
+	constexpr uint32_t ANSWER_COUNT = 200U;
+	DuelExecutor executor({4U, 3U});
+	EXPECT_EQ(executor.worker_count(), 4U);
+	std::vector<std::shared_ptr<FakeDuel::Log>> logs;
+	std::vector<DuelExecutor::DuelId> ids;
+	for(size_t i = 0U; i < DUEL_COUNT; i++)
+	{
+		auto const& log = logs.emplace_back(std::make_shared<FakeDuel::Log>());
+		ids.push_back(executor.add(std::make_unique<FakeDuel>(log)));
+	}
+	// Answers come from several threads, each feeding its own duels.
+	std::vector<std::thread> feeders;
+	for(size_t t = 0U; t < 4U; t++)
+	{
+		feeders.emplace_back(
+			[&, t]()
+			{
+				for(uint32_t n = 0U; n < ANSWER_COUNT; n++)
+				{
+					for(size_t i = t; i < DUEL_COUNT; i += 4U)
+					{
+						auto const id = ids[i];
+						EXPECT_TRUE(executor.submit_answer(id, make_answer(n)));
+					}
+				}
+			});
+	}
+	for(auto& t : feeders)
+		t.join();
+	auto const total = DUEL_COUNT * (ANSWER_COUNT + 1U);
+	ASSERT_TRUE(wait_for([&]() { return executor.metrics().steps == total; }));
+	for(auto const& log : logs)
+	{
+		std::scoped_lock lock(log->mutex);
+		EXPECT_TRUE(log->started);
+		EXPECT_FALSE(log->overlapped);
+		ASSERT_EQ(log->answers.size(), ANSWER_COUNT);
+		for(uint32_t n = 0U; n < ANSWER_COUNT; n++)
+			EXPECT_EQ(log->answers[n], n);
+	}
+	auto const m = executor.metrics();
+	EXPECT_EQ(m.duel_count, DUEL_COUNT);
+	EXPECT_EQ(m.queue_depth, 0U);
+	EXPECT_EQ(m.worker_queue_depths.size(), 4U);
+	DuelExecutor::DuelMetrics dm{};
+	ASSERT_TRUE(executor.duel_metrics(ids[0], dm));
+	EXPECT_EQ(dm.steps, ANSWER_COUNT + 1U);
+	EXPECT_EQ(dm.pending_answers, 0U);
+	EXPECT_GE(dm.total_step, dm.max_step);
+	EXPECT_GE(dm.max_step, dm.last_step);
+}
+
+TEST(DuelExecutorTest, AnswersCanBeSubmittedFromWithinSteps)
+{
+	constexpr uint32_t LAST = 1000U;
+	DuelExecutor executor({2U, 16U});
+	auto log = std::make_shared<FakeDuel::Log>();
+	DuelExecutor::DuelId id = 0U;
+	std::atomic<bool> added{false};
+	// Each answer makes the duel answer itself with the next number, much like
+	// a process callback sending messages to a bot that replies right away.
+	auto on_answer = [&](uint32_t n)
+	{
+		while(!added)
+			std::this_thread::yield();
+		if(n < LAST)
+			executor.submit_answer(id, make_answer(n + 1U));
+	};
+	id = executor.add(std::make_unique<FakeDuel>(log, on_answer));
+	added = true;
+	ASSERT_TRUE(executor.submit_answer(id, make_answer(0U)));
+	ASSERT_TRUE(wait_for([&]() { return log->steps == LAST + 2U; }));
+	std::scoped_lock lock(log->mutex);
+	EXPECT_FALSE(log->overlapped);
+	for(uint32_t n = 0U; n <= LAST; n++)
+		EXPECT_EQ(log->answers[n], n);
+}
+
+TEST(DuelExecutorTest, RemovedDuelsStopRunning)
+{
+	DuelExecutor executor({1U, 1U});
+	auto log = std::make_shared<FakeDuel::Log>();
+	auto const id = executor.add(std::make_unique<FakeDuel>(log));
+	ASSERT_TRUE(wait_for([&]() { return log->steps == 1U; }));
+	EXPECT_TRUE(executor.remove(id));
+	EXPECT_FALSE(executor.remove(id));
+	EXPECT_FALSE(executor.submit_answer(id, make_answer(1U)));
+	DuelExecutor::DuelMetrics dm{};
+	EXPECT_FALSE(executor.duel_metrics(id, dm));
+	EXPECT_EQ(executor.metrics().duel_count, 0U);
+	// The executor dropped its duel.
+	ASSERT_TRUE(wait_for([&]() { return log.use_count() == 1; }));
+	EXPECT_TRUE(log->answers.empty());
+}
+
+TEST(DuelExecutorTest, RemovingADuelMidBatchDropsTheRestOfIt)
+{
+	DuelExecutor executor({1U, 16U});
+	std::atomic<bool> in_step{false};
+	std::atomic<bool> go{false};
+	auto block_on_first = [&](uint32_t n)
+	{
+		if(n != 0U)
+			return;
+		in_step = true;
+		while(!go)
+			std::this_thread::yield();
+	};
+	// Keep the only worker busy so the answers below pile up in one batch.
+	auto blocker_log = std::make_shared<FakeDuel::Log>();
+	auto const blocker =
+		executor.add(std::make_unique<FakeDuel>(blocker_log, block_on_first));
+	ASSERT_TRUE(executor.submit_answer(blocker, make_answer(0U)));
+	ASSERT_TRUE(wait_for([&]() { return in_step.load(); }));
+	in_step = false;
+	auto log = std::make_shared<FakeDuel::Log>();
+	std::atomic<bool> removed{false};
+	auto const id = executor.add(std::make_unique<FakeDuel>(
+		log,
+		[&](uint32_t n)
+		{
+			if(n != 0U)
+				return;
+			in_step = true;
+			while(!removed)
+				std::this_thread::yield();
+		}));
+	for(uint32_t n = 0U; n < 10U; n++)
+		ASSERT_TRUE(executor.submit_answer(id, make_answer(n)));
+	go = true;
+	ASSERT_TRUE(wait_for([&]() { return in_step.load(); }));
+	EXPECT_TRUE(executor.remove(id));
+	removed = true;
+	ASSERT_TRUE(wait_for([&]() { return log.use_count() == 1; }));
+	EXPECT_EQ(log->answers, std::vector<uint32_t>{0U});
+}
+
+TEST(DuelExecutorTest, DestroyingTheExecutorMidBatchDropsTheRestOfIt)
+{
+	auto executor =
+		std::make_unique<DuelExecutor>(DuelExecutor::Options{1U, 16U});
+	std::atomic<bool> in_step{false};
+	std::atomic<bool> go{false};
+	auto block_on_first = [&](uint32_t n)
+	{
+		if(n != 0U)
+			return;
+		in_step = true;
+		while(!go)
+			std::this_thread::yield();
+	};
+	// Keep the only worker busy so the answers below pile up in one batch.
+	auto blocker_log = std::make_shared<FakeDuel::Log>();
+	auto const blocker =
+		executor->add(std::make_unique<FakeDuel>(blocker_log, block_on_first));
+	ASSERT_TRUE(executor->submit_answer(blocker, make_answer(0U)));
+	ASSERT_TRUE(wait_for([&]() { return in_step.load(); }));
+	in_step = false;
+	auto log = std::make_shared<FakeDuel::Log>();
+	std::atomic<bool> release{false};
+	auto const id = executor->add(std::make_unique<FakeDuel>(
+		log,
+		[&](uint32_t n)
+		{
+			if(n != 0U)
+				return;
+			in_step = true;
+			while(!release)
+				std::this_thread::yield();
+		}));
+	for(uint32_t n = 0U; n < 10U; n++)
+		ASSERT_TRUE(executor->submit_answer(id, make_answer(n)));
+	go = true;
+	ASSERT_TRUE(wait_for([&]() { return in_step.load(); }));
+	std::thread destroyer([&]() { executor.reset(); });
+	// NOTE: Gives the destructor time to tell the worker to stop.
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	release = true;
+	destroyer.join();
+	EXPECT_EQ(log->answers, std::vector<uint32_t>{0U});
+}
+
+} // namespace
@@ -0,0 +1,706 @@
+/*
+ * Copyright (c) 2024, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include <cstring>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/repeated_ptr_field.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ygopen/codec/edo9300_ocgcore_encode.hpp>
+#include <ygopen/codec/edo9300_ocgcore_encode.inl>
+#include <ygopen/duel/constants/phase.hpp>
+#include <ygopen/server/basic_encode_context.hpp>
+#include <ygopen/server/slim_encode_context.hpp>
+
+namespace
+{
+
+using namespace YGOpen::Codec;
+using namespace YGOpen::Codec::Edo9300::OCGCore;
+using namespace YGOpen::Duel;
+using namespace YGOpen::Proto::Duel;
+
+// Writes core messages the same way `OCG_DuelGetMessage` lays them out.
+class CoreBuffer
+{
+public:
+	template<typename T>
+	auto write(T value) noexcept -> CoreBuffer&
+	{
+		auto const pos = data_.size();
+		data_.resize(pos + sizeof(T));
+		std::memcpy(data_.data() + pos, &value, sizeof(T));
+		return *this;
+	}
+
+	auto begin_msg(uint8_t type) noexcept -> CoreBuffer&
+	{
+		msg_start_ = data_.size();
+		write<uint32_t>(0U);
+		return write(type);
+	}
+
+	auto end_msg() noexcept -> CoreBuffer&
+	{
+		auto const size =
+			static_cast<uint32_t>(data_.size() - msg_start_ - sizeof(uint32_t));
+		std::memcpy(data_.data() + msg_start_, &size, sizeof(uint32_t));
+		return *this;
+	}
+
+	[[nodiscard]] auto data() const noexcept -> uint8_t const*
+	{
+		return data_.data();
+	}
+
+	[[nodiscard]] auto size() const noexcept -> size_t { return data_.size(); }
+
+private:
+	std::vector<uint8_t> data_;
+	size_t msg_start_{};
+};
+
+constexpr uint8_t MSG_START = 4U;
+constexpr uint8_t MSG_UPDATE_DATA = 6U;
+constexpr uint8_t MSG_UPDATE_CARD = 7U;
+constexpr uint8_t MSG_HINT = 2U;
+constexpr uint8_t MSG_WAITING = 3U; // NOTE: Not known by the encoder.
+constexpr uint8_t MSG_NEW_TURN = 40U;
+constexpr uint8_t MSG_NEW_PHASE = 41U;
+constexpr uint8_t MSG_DRAW = 90U;
+constexpr uint8_t MSG_WIN = 5U;
+constexpr uint8_t MSG_MATCH_KILL = 170U;
+
+class EncodeAllTest : public ::testing::Test
+{
+protected:
+	google::protobuf::Arena arena;
+	YGOpen::Server::BasicEncodeContext context;
+	google::protobuf::RepeatedPtrField<Msg>* out =
+		google::protobuf::Arena::CreateMessage<
+			google::protobuf::RepeatedPtrField<Msg>>(&arena);
+	CoreBuffer buffer;
+
+	auto encode() noexcept -> EncodeAllResult
+	{
+		return encode_all(context, buffer.data(), buffer.size(), *out);
+	}
+};
+
+TEST_F(EncodeAllTest, EmptyBufferWorks)
+{
+	auto const result = encode();
+	EXPECT_EQ(result.msgs_read, 0U);
+	EXPECT_EQ(result.unknown_count, 0U);
+	EXPECT_EQ(result.malformed_count, 0U);
+	EXPECT_EQ(result.bytes_read, 0U);
+	EXPECT_TRUE(out->empty());
+}
+
+TEST_F(EncodeAllTest, SwallowedMessagesAreNotAppended)
+{
+	buffer.begin_msg(MSG_NEW_TURN).write<uint8_t>(1U).end_msg();
+	buffer.begin_msg(MSG_HINT)
+		.write<uint8_t>(1U)
+		.write<uint8_t>(0U)
+		.write<uint64_t>(0U)
+		.end_msg();
+	buffer.begin_msg(MSG_NEW_PHASE).write<uint16_t>(PHASE_DRAW).end_msg();
+	auto const result = encode();
+	EXPECT_EQ(result.msgs_read, 3U);
+	EXPECT_EQ(result.unknown_count, 0U);
+	EXPECT_EQ(result.bytes_read, buffer.size());
+	ASSERT_EQ(out->size(), 2);
+	EXPECT_EQ(out->Get(0).event().next_turn(), 1);
+	EXPECT_EQ(out->Get(1).event().next_phase(), PHASE_DRAW);
+}
+
+TEST_F(EncodeAllTest, UnknownMessagesAreSkipped)
+{
+	buffer.begin_msg(MSG_WAITING).write<uint32_t>(0xDEADBEEF).end_msg();
+	buffer.begin_msg(MSG_NEW_TURN).write<uint8_t>(0U).end_msg();
+	auto const result = encode();
+	EXPECT_EQ(result.msgs_read, 2U);
+	EXPECT_EQ(result.unknown_count, 1U);
+	ASSERT_EQ(out->size(), 1);
+	EXPECT_EQ(out->Get(0).event().next_turn(), 0);
+}
+
+TEST_F(EncodeAllTest, TruncatedMessageIsNotRead)
+{
+	buffer.begin_msg(MSG_NEW_TURN).write<uint8_t>(1U).end_msg();
+	auto const complete_size = buffer.size();
+	buffer.begin_msg(MSG_NEW_PHASE).write<uint16_t>(PHASE_DRAW).end_msg();
+	auto const result =
+		encode_all(context, buffer.data(), buffer.size() - 1U, *out);
+	EXPECT_EQ(result.msgs_read, 1U);
+	EXPECT_EQ(result.bytes_read, complete_size);
+	EXPECT_EQ(out->size(), 1);
+}
+
+TEST_F(EncodeAllTest, EmptyMessagesAreMalformed)
+{
+	buffer.write<uint32_t>(0U);
+	buffer.begin_msg(MSG_NEW_TURN).write<uint8_t>(1U).end_msg();
+	buffer.write<uint32_t>(0U);
+	auto const result = encode();
+	EXPECT_EQ(result.msgs_read, 3U);
+	EXPECT_EQ(result.malformed_count, 2U);
+	EXPECT_EQ(result.bytes_read, buffer.size());
+	ASSERT_EQ(out->size(), 1);
+	EXPECT_EQ(out->Get(0).event().next_turn(), 1);
+}
+
+TEST_F(EncodeAllTest, ShortMessagesAreMalformed)
+{
+	// NOTE: One byte short of the phase, which would be read from the next.
+	buffer.begin_msg(MSG_NEW_PHASE).write<uint8_t>(PHASE_DRAW).end_msg();
+	buffer.begin_msg(MSG_NEW_TURN).write<uint8_t>(1U).end_msg();
+	auto const result = encode();
+	EXPECT_EQ(result.msgs_read, 2U);
+	EXPECT_EQ(result.malformed_count, 1U);
+	EXPECT_EQ(result.unknown_count, 0U);
+	EXPECT_EQ(result.bytes_read, buffer.size());
+	ASSERT_EQ(out->size(), 1);
+	EXPECT_EQ(out->Get(0).event().next_turn(), 1);
+}
+
+TEST_F(EncodeAllTest, ShortLastMessageIsNotReadPastTheBuffer)
+{
+	buffer.begin_msg(MSG_NEW_PHASE).write<uint8_t>(PHASE_DRAW).end_msg();
+	// NOTE: Exactly as big as the messages, so that reading past them is
+	// caught by sanitizers.
+	auto const data = std::make_unique<uint8_t[]>(buffer.size());
+	std::memcpy(data.get(), buffer.data(), buffer.size());
+	auto const result = encode_all(context, data.get(), buffer.size(), *out);
+	EXPECT_EQ(result.msgs_read, 1U);
+	EXPECT_EQ(result.malformed_count, 1U);
+	EXPECT_EQ(result.bytes_read, buffer.size());
+	EXPECT_TRUE(out->empty());
+}
+
+TEST_F(EncodeAllTest, ShortMessagesDoNotChangeTheContext)
+{
+	constexpr uint32_t MATCH_WIN_REASON = 0x101U;
+	buffer.begin_msg(MSG_MATCH_KILL)
+		.write<uint16_t>(MATCH_WIN_REASON)
+		.end_msg();
+	buffer.begin_msg(MSG_WIN).write<uint8_t>(0U).write<uint8_t>(1U).end_msg();
+	auto const result = encode();
+	EXPECT_EQ(result.msgs_read, 2U);
+	EXPECT_EQ(result.malformed_count, 1U);
+	EXPECT_EQ(context.get_match_win_reason(), 0U);
+	ASSERT_EQ(out->size(), 1);
+	EXPECT_EQ(out->Get(0).event().finish().match_win_reason(), 0U);
+}
+
+TEST_F(EncodeAllTest, ContextIsUpdatedBetweenMessages)
+{
+	constexpr uint16_t MAIN_DECK_SIZE = 40U;
+	constexpr uint32_t DRAW_COUNT = 5U;
+	buffer.begin_msg(MSG_START)
+		.write<uint8_t>(0U)
+		.write<uint32_t>(8000U)
+		.write<uint32_t>(8000U);
+	for(int i = 0; i < 2; i++)
+		buffer.write<uint16_t>(MAIN_DECK_SIZE).write<uint16_t>(0U);
+	buffer.end_msg();
+	buffer.begin_msg(MSG_DRAW).write<uint8_t>(0U).write(DRAW_COUNT);
+	for(uint32_t i = 0; i < DRAW_COUNT; i++)
+		buffer.write<uint32_t>(0U).write<uint32_t>(0U);
+	buffer.end_msg();
+	auto const result = encode();
+	EXPECT_EQ(result.msgs_read, 2U);
+	ASSERT_EQ(out->size(), 2);
+	auto const& op = out->Get(1).event().pile().splice().ops(0);
+	EXPECT_EQ(op.from().seq(), MAIN_DECK_SIZE - DRAW_COUNT);
+	EXPECT_EQ(op.to().seq(), 0U);
+	EXPECT_EQ(context.pile_size(CONTROLLER_0, LOCATION_HAND), DRAW_COUNT);
+}
+
+TEST(EncodeSerializedTest, BytesMatchSerializedMsg)
+{
+	CoreBuffer buffer;
+	buffer.begin_msg(MSG_NEW_TURN).write<uint8_t>(1U).end_msg();
+	buffer.begin_msg(MSG_HINT)
+		.write<uint8_t>(1U)
+		.write<uint8_t>(0U)
+		.write<uint64_t>(0U)
+		.end_msg();
+	buffer.begin_msg(MSG_START)
+		.write<uint8_t>(0U)
+		.write<uint32_t>(8000U)
+		.write<uint32_t>(4000U);
+	for(int i = 0; i < 2; i++)
+		buffer.write<uint16_t>(40U).write<uint16_t>(15U);
+	buffer.end_msg();
+	buffer.begin_msg(MSG_NEW_PHASE).write<uint16_t>(PHASE_MAIN_1).end_msg();
+	google::protobuf::Arena arena;
+	YGOpen::Server::BasicEncodeContext context;
+	Msg scratch;
+	std::string expected;
+	std::string out;
+	std::string stream_out;
+	google::protobuf::io::StringOutputStream stream(&stream_out);
+	for(size_t pos = 0U; pos < buffer.size();)
+	{
+		uint32_t size{};
+		std::memcpy(&size, buffer.data() + pos, sizeof(uint32_t));
+		auto const* data = buffer.data() + pos + sizeof(uint32_t);
+		auto const eor = encode_one(arena, context, data);
+		auto const eor_s = encode_one(context, data, scratch, out);
+		EXPECT_EQ(eor.state, eor_s.state);
+		EXPECT_EQ(eor.bytes_read, eor_s.bytes_read);
+		if(eor.state == EncodeOneResult::State::OK)
+		{
+			EXPECT_EQ(eor_s.msg, &scratch);
+			eor.msg->AppendToString(&expected);
+		}
+		static_cast<void>(encode_one(context, data, scratch, stream));
+		pos += sizeof(uint32_t) + size;
+	}
+	EXPECT_FALSE(expected.empty());
+	EXPECT_EQ(out, expected);
+	// NOTE: StringOutputStream grows its string ahead of what was written.
+	EXPECT_EQ(stream_out.substr(0U, stream.ByteCount()), expected);
+}
+
+TEST(EncodeSerializedTest, FailingOutputIsReported)
+{
+	CoreBuffer buffer;
+	buffer.begin_msg(MSG_NEW_PHASE).write<uint16_t>(PHASE_MAIN_1).end_msg();
+	auto const* data = buffer.data() + sizeof(uint32_t);
+	YGOpen::Server::BasicEncodeContext context;
+	Msg scratch;
+	// NOTE: Too small to fit any message.
+	uint8_t storage[1];
+	google::protobuf::io::ArrayOutputStream stream(storage, sizeof(storage));
+	auto const eor = encode_one(context, data, scratch, stream);
+	EXPECT_EQ(eor.state, EncodeOneResult::State::SERIALIZE_FAILED);
+	EXPECT_EQ(eor.msg, &scratch);
+	EXPECT_EQ(eor.bytes_read, buffer.size() - sizeof(uint32_t));
+}
+
+// Queries of a card with every query the encoder knows, and a couple more.
+auto write_every_query(CoreBuffer& buffer) noexcept -> void
+{
+	auto const query = [&buffer](uint32_t flag, auto value)
+	{
+		buffer.write<uint16_t>(sizeof(flag) + sizeof(value))
+			.write(flag)
+			.write(value);
+	};
+	auto const loc_info = [&buffer](uint8_t con, uint8_t loc, uint32_t seq,
+	                                uint32_t pos)
+	{
+		buffer.write(con).write(loc).write(seq).write(pos);
+	};
+	query(0x1U, uint32_t{89631139U});    // Code.
+	query(0x2U, uint32_t{0U});           // Position, present but 0.
+	query(0x10U, uint32_t{0xFFFFFFFFU}); // Level, negative once stored.
+	query(0x80U, uint64_t{1U} << 40U);   // Race, past 32 bits.
+	query(0x100U, int32_t{-2});          // Attack.
+	query(0x1000U, uint32_t{0U});        // Reason, unused and thus skipped.
+	buffer.write<uint16_t>(sizeof(uint32_t) + 10U).write<uint32_t>(0x4000U);
+	loc_info(1U, LOCATION_SPELL_ZONE, 5U, 0U); // Equipped to the field zone.
+	buffer.write<uint16_t>(sizeof(uint32_t) * 2U + 20U)
+		.write<uint32_t>(0x8000U)
+		.write<uint32_t>(2U);
+	loc_info(0U, LOCATION_MONSTER_ZONE, 2U, 0x5U);
+	loc_info(1U, LOCATION_MONSTER_ZONE | 0x80U, 3U, 1U); // A material.
+	buffer.write<uint16_t>(sizeof(uint32_t) * 4U)
+		.write<uint32_t>(0x10000U) // Overlay cards.
+		.write<uint32_t>(2U)
+		.write<uint32_t>(111U)
+		.write<uint32_t>(0U);
+	buffer.write<uint16_t>(sizeof(uint32_t) * 3U)
+		.write<uint32_t>(0x20000U) // Counters.
+		.write<uint32_t>(1U)
+		.write<uint32_t>(0x30001U);
+	query(0x40000U, uint8_t{1U});  // Owner.
+	query(0x100000U, uint8_t{1U}); // Is public.
+	buffer.write<uint16_t>(sizeof(uint32_t) * 3U)
+		.write<uint32_t>(0x800000U) // Link.
+		.write<int32_t>(2)
+		.write<uint32_t>(0x28U);
+	query(0x1000000U, uint8_t{0U});     // Is hidden, present but false.
+	query(0x2000000U, uint32_t{1234U}); // Cover.
+	buffer.write<uint16_t>(sizeof(uint32_t)).write<uint32_t>(0x80000000U);
+}
+
+// Encodes each message in `buffer` both ways and compares the bytes.
+auto expect_written_as_serialized(CoreBuffer const& buffer) noexcept -> void
+{
+	google::protobuf::Arena arena;
+	YGOpen::Server::SlimEncodeContext context;
+	ASSERT_FALSE(context.needs_queries());
+	Msg scratch;
+	for(size_t pos = 0U; pos < buffer.size();)
+	{
+		uint32_t size{};
+		std::memcpy(&size, buffer.data() + pos, sizeof(uint32_t));
+		auto const* data = buffer.data() + pos + sizeof(uint32_t);
+		auto const eor = encode_one(arena, context, data);
+		ASSERT_EQ(eor.state, EncodeOneResult::State::OK);
+		std::string expected;
+		ASSERT_TRUE(eor.msg->SerializeToString(&expected));
+		std::string out = "prefix";
+		auto const eor_s = encode_one(context, data, scratch, out);
+		EXPECT_EQ(eor_s.state, EncodeOneResult::State::OK);
+		EXPECT_EQ(eor_s.msg, nullptr);
+		EXPECT_EQ(eor_s.bytes_read, eor.bytes_read);
+		EXPECT_EQ(out, "prefix" + expected);
+		std::string stream_out;
+		{
+			google::protobuf::io::StringOutputStream stream(&stream_out);
+			static_cast<void>(encode_one(context, data, scratch, stream));
+		}
+		EXPECT_EQ(stream_out, expected);
+		pos += sizeof(uint32_t) + size;
+	}
+}
+
+TEST(EncodeWireTest, UpdateDataIsWrittenAsSerialized)
+{
+	CoreBuffer queries;
+	queries.write<uint16_t>(0U);
+	write_every_query(queries);
+	for(int i = 0; i < 3; i++)
+		queries.write<uint16_t>(0U);
+	// Field zone and then pendulum zone, with their queries out of order.
+	for(int i = 0; i < 2; i++)
+	{
+		queries.write<uint16_t>(sizeof(uint32_t) * 2U)
+			.write<uint32_t>(0x100U)
+			.write<int32_t>(1000 * i);
+		queries.write<uint16_t>(sizeof(uint32_t) * 2U)
+			.write<uint32_t>(0x1U)
+			.write<uint32_t>(12345U);
+		queries.write<uint16_t>(sizeof(uint32_t)).write<uint32_t>(0x80000000U);
+	}
+	CoreBuffer buffer;
+	buffer.begin_msg(MSG_UPDATE_DATA)
+		.write<uint8_t>(1U)
+		.write<uint8_t>(LOCATION_SPELL_ZONE)
+		.write(static_cast<uint32_t>(queries.size()));
+	for(size_t i = 0U; i < queries.size(); i++)
+		buffer.write(queries.data()[i]);
+	buffer.end_msg();
+	buffer.begin_msg(MSG_UPDATE_DATA)
+		.write<uint8_t>(0U)
+		.write<uint8_t>(LOCATION_GRAVEYARD)
+		.write<uint32_t>(0U)
+		.end_msg();
+	expect_written_as_serialized(buffer);
+}
+
+TEST(EncodeWireTest, UpdateCardIsWrittenAsSerialized)
+{
+	CoreBuffer buffer;
+	buffer.begin_msg(MSG_UPDATE_CARD)
+		.write<uint8_t>(0U)
+		.write<uint8_t>(LOCATION_MONSTER_ZONE)
+		.write<uint8_t>(4U);
+	write_every_query(buffer);
+	buffer.end_msg();
+	expect_written_as_serialized(buffer);
+}
+
+TEST(EncodeWireTest, ListsSentTwiceAreAppended)
+{
+	CoreBuffer buffer;
+	buffer.begin_msg(MSG_UPDATE_CARD)
+		.write<uint8_t>(0U)
+		.write<uint8_t>(LOCATION_MONSTER_ZONE)
+		.write<uint8_t>(4U);
+	for(uint32_t i = 0U; i < 2U; i++)
+	{
+		buffer.write<uint16_t>(sizeof(uint32_t) * 3U)
+			.write<uint32_t>(0x20000U) // Counters.
+			.write<uint32_t>(1U)
+			.write<uint32_t>(0x10001U + i);
+	}
+	buffer.write<uint16_t>(sizeof(uint32_t)).write<uint32_t>(0x80000000U);
+	buffer.end_msg();
+	expect_written_as_serialized(buffer);
+}
+
+TEST(EncodeWireTest, FailingOutputIsReported)
+{
+	CoreBuffer buffer;
+	buffer.begin_msg(MSG_UPDATE_CARD)
+		.write<uint8_t>(0U)
+		.write<uint8_t>(LOCATION_MONSTER_ZONE)
+		.write<uint8_t>(4U);
+	write_every_query(buffer);
+	buffer.end_msg();
+	auto const* data = buffer.data() + sizeof(uint32_t);
+	YGOpen::Server::SlimEncodeContext context;
+	Msg scratch;
+	uint8_t storage[16];
+	google::protobuf::io::ArrayOutputStream stream(storage, sizeof(storage));
+	auto const eor = encode_one(context, data, scratch, stream);
+	EXPECT_EQ(eor.state, EncodeOneResult::State::SERIALIZE_FAILED);
+	EXPECT_EQ(eor.msg, nullptr);
+	EXPECT_EQ(eor.bytes_read, buffer.size() - sizeof(uint32_t));
+}
+
+TEST(EncodeWireTest, ContextsNeedingQueriesGetTheirMsg)
+{
+	CoreBuffer buffer;
+	buffer.begin_msg(MSG_UPDATE_CARD)
+		.write<uint8_t>(0U)
+		.write<uint8_t>(LOCATION_MONSTER_ZONE)
+		.write<uint8_t>(4U);
+	write_every_query(buffer);
+	buffer.end_msg();
+	YGOpen::Server::BasicEncodeContext context(true);
+	ASSERT_TRUE(context.needs_queries());
+	Msg scratch;
+	std::string out;
+	auto const eor =
+		encode_one(context, buffer.data() + sizeof(uint32_t), scratch, out);
+	EXPECT_EQ(eor.state, EncodeOneResult::State::OK);
+	EXPECT_EQ(eor.msg, &scratch);
+	EXPECT_EQ(scratch.queries_size(), 3);
+}
+
+TEST(EncodeOneQueryTest, EveryQueryIsReadIntoItsField)
+{
+	CoreBuffer buffer;
+	auto const query = [&buffer](uint32_t flag, auto value)
+	{
+		buffer.write<uint16_t>(sizeof(flag) + sizeof(value))
+			.write(flag)
+			.write(value);
+	};
+	query(0x1U, uint32_t{89631139U}); // Code.
+	query(0x40U, uint32_t{0x10U});    // Attribute.
+	query(0x80U, uint64_t{0x2U});     // Race.
+	query(0x100U, int32_t{3000});     // Attack.
+	query(0x1000U, uint32_t{0U});     // Reason, unused and thus skipped.
+	query(0x100000U, uint8_t{1U});    // Is public.
+	buffer.write<uint16_t>(sizeof(uint32_t) + sizeof(uint32_t) * 3U)
+		.write<uint32_t>(0x10000U) // Overlay cards.
+		.write<uint32_t>(2U)
+		.write<uint32_t>(1U)
+		.write<uint32_t>(2U);
+	buffer.write<uint16_t>(sizeof(uint32_t)).write<uint32_t>(0x80000000U);
+	Msg::Query::Data q;
+	auto const result = encode_one_query(buffer.data(), q);
+	EXPECT_EQ(result.bytes_read, buffer.size());
+	EXPECT_EQ(q.code().value(), 89631139U);
+	EXPECT_EQ(q.attribute().value(), 0x10U);
+	EXPECT_EQ(q.race().value(), 0x2U);
+	EXPECT_EQ(q.atk().value(), 3000);
+	EXPECT_TRUE(q.is_public().value());
+	EXPECT_FALSE(q.has_def());
+	EXPECT_EQ(result.overlays_count, 2U);
+	ASSERT_NE(result.overlays_ptr, nullptr);
+	uint32_t overlay{};
+	std::memcpy(&overlay, result.overlays_ptr, sizeof(uint32_t));
+	EXPECT_EQ(overlay, 1U);
+}
+
+TEST(EncodeUpdateDataTest, CardsAreReadFromTheirBoundaries)
+{
+	// Queries of 2 monsters: an empty zone and then one with 2 overlays.
+	CoreBuffer queries;
+	queries.write<uint16_t>(0U);
+	queries.write<uint16_t>(sizeof(uint32_t) * 2U)
+		.write<uint32_t>(0x1U)
+		.write<uint32_t>(12345U);
+	queries.write<uint16_t>(sizeof(uint32_t) * 4U)
+		.write<uint32_t>(0x10000U)
+		.write<uint32_t>(2U)
+		.write<uint32_t>(111U)
+		.write<uint32_t>(222U);
+	queries.write<uint16_t>(sizeof(uint32_t)).write<uint32_t>(0x80000000U);
+	CoreBuffer buffer;
+	buffer.begin_msg(MSG_UPDATE_DATA)
+		.write<uint8_t>(1U)
+		.write<uint8_t>(LOCATION_MONSTER_ZONE)
+		.write(static_cast<uint32_t>(queries.size()));
+	for(size_t i = 0U; i < queries.size(); i++)
+		buffer.write(queries.data()[i]);
+	buffer.end_msg();
+	google::protobuf::Arena arena;
+	YGOpen::Server::BasicEncodeContext context;
+	auto const* data = buffer.data() + sizeof(uint32_t);
+	auto const eor = encode_one(arena, context, data);
+	ASSERT_EQ(eor.state, EncodeOneResult::State::OK);
+	EXPECT_EQ(eor.bytes_read, buffer.size() - sizeof(uint32_t));
+	auto const& q = eor.msg->queries();
+	ASSERT_EQ(q.size(), 3);
+	EXPECT_EQ(q.Get(0).place().con(), CONTROLLER_1);
+	EXPECT_EQ(q.Get(0).place().seq(), 1U);
+	EXPECT_EQ(q.Get(0).data().code().value(), 12345U);
+	EXPECT_EQ(q.Get(1).place().oseq(), 0U);
+	EXPECT_EQ(q.Get(1).data().code().value(), 111U);
+	EXPECT_EQ(q.Get(2).place().oseq(), 1U);
+	EXPECT_EQ(q.Get(2).data().code().value(), 222U);
+}
+
+TEST(EncodeDeltaTest, OnlyChangedValuesAreKept)
+{
+	CoreBuffer buffer;
+	buffer.begin_msg(MSG_START)
+		.write<uint8_t>(0U)
+		.write<uint32_t>(8000U)
+		.write<uint32_t>(8000U);
+	for(int i = 0; i < 2; i++)
+		buffer.write<uint16_t>(1U).write<uint16_t>(0U);
+	buffer.end_msg();
+	auto const update_card = [&buffer](int32_t atk)
+	{
+		buffer.begin_msg(MSG_UPDATE_CARD)
+			.write<uint8_t>(0U)
+			.write<uint8_t>(LOCATION_MAIN_DECK)
+			.write<uint8_t>(0U);
+		buffer.write<uint16_t>(sizeof(uint32_t) * 2U)
+			.write<uint32_t>(0x1U)
+			.write<uint32_t>(12345U);
+		buffer.write<uint16_t>(sizeof(uint32_t) * 2U)
+			.write<uint32_t>(0x100U)
+			.write(atk);
+		buffer.write<uint16_t>(sizeof(uint32_t)).write<uint32_t>(0x80000000U);
+		buffer.end_msg();
+	};
+	update_card(1000);
+	update_card(2000);
+	update_card(2000);
+	google::protobuf::Arena arena;
+	YGOpen::Server::BasicEncodeContext context(true);
+	auto* out = google::protobuf::Arena::CreateMessage<
+		google::protobuf::RepeatedPtrField<Msg>>(&arena);
+	auto const result = encode_all(context, buffer.data(), buffer.size(), *out);
+	EXPECT_EQ(result.msgs_read, 4U);
+	// NOTE: The last message changed nothing, so it is not kept at all.
+	ASSERT_EQ(out->size(), 3);
+	auto const& first = out->Get(1).queries(0).data();
+	EXPECT_TRUE(first.has_code());
+	EXPECT_EQ(first.atk().value(), 1000);
+	ASSERT_EQ(out->Get(2).queries_size(), 1);
+	auto const& second = out->Get(2).queries(0).data();
+	EXPECT_FALSE(second.has_code());
+	EXPECT_EQ(second.atk().value(), 2000);
+}
+
+TEST(EncodeDeltaTest, UnchangedUpdateDataIsDropped)
+{
+	CoreBuffer buffer;
+	buffer.begin_msg(MSG_START)
+		.write<uint8_t>(0U)
+		.write<uint32_t>(8000U)
+		.write<uint32_t>(8000U);
+	for(int i = 0; i < 2; i++)
+		buffer.write<uint16_t>(1U).write<uint16_t>(0U);
+	buffer.end_msg();
+	CoreBuffer queries;
+	queries.write<uint16_t>(sizeof(uint32_t) * 2U)
+		.write<uint32_t>(0x1U)
+		.write<uint32_t>(12345U);
+	queries.write<uint16_t>(sizeof(uint32_t)).write<uint32_t>(0x80000000U);
+	for(int i = 0; i < 2; i++)
+	{
+		buffer.begin_msg(MSG_UPDATE_DATA)
+			.write<uint8_t>(0U)
+			.write<uint8_t>(LOCATION_MAIN_DECK)
+			.write(static_cast<uint32_t>(queries.size()));
+		for(size_t j = 0U; j < queries.size(); j++)
+			buffer.write(queries.data()[j]);
+		buffer.end_msg();
+	}
+	google::protobuf::Arena arena;
+	YGOpen::Server::BasicEncodeContext context(true);
+	auto* out = google::protobuf::Arena::CreateMessage<
+		google::protobuf::RepeatedPtrField<Msg>>(&arena);
+	auto const result = encode_all(context, buffer.data(), buffer.size(), *out);
+	EXPECT_EQ(result.msgs_read, 3U);
+	ASSERT_EQ(out->size(), 2);
+	ASSERT_EQ(out->Get(1).queries_size(), 1);
+	EXPECT_EQ(out->Get(1).queries(0).data().code().value(), 12345U);
+}
+
+// Context from outside the library, forwarding to a BasicEncodeContext
+// without inheriting from `IEncodeContext`.
+class ForwardingContext final
+{
+public:
+	using Con = IEncodeContext::Con;
+	using Loc = IEncodeContext::Loc;
+	using Place = IEncodeContext::Place;
+
+	auto pile_size(Con con, Loc loc) const noexcept -> size_t
+	{
+		return c_.pile_size(con, loc);
+	}
+
+	auto get_match_win_reason() const noexcept -> uint32_t
+	{
+		return c_.get_match_win_reason();
+	}
+
+	auto has_xyz_mat(Place const& p) const noexcept -> bool
+	{
+		return c_.has_xyz_mat(p);
+	}
+
+	auto get_xyz_left(Place const& p) const noexcept -> Place
+	{
+		return c_.get_xyz_left(p);
+	}
+
+	auto match_win_reason(uint32_t r) noexcept -> void
+	{
+		c_.match_win_reason(r);
+	}
+
+	auto xyz_mat_defer(Place const& p) noexcept -> void { c_.xyz_mat_defer(p); }
+
+	auto deferred_xyz_mat() const noexcept -> std::vector<Place> const&
+	{
+		return c_.deferred_xyz_mat();
+	}
+
+	auto clear_deferred_xyz_mat() noexcept -> void
+	{
+		c_.clear_deferred_xyz_mat();
+	}
+
+	auto xyz_left(Place const& a, Place const& b) noexcept -> void
+	{
+		c_.xyz_left(a, b);
+	}
+
+	auto parse(Msg& msg) noexcept -> bool { return c_.parse(msg); }
+
+private:
+	YGOpen::Server::BasicEncodeContext c_;
+};
+
+#ifdef YGOPEN_HAS_CONCEPTS
+static_assert(EncodeContext<ForwardingContext>);
+#endif // YGOPEN_HAS_CONCEPTS
+
+TEST(EncodeCustomContextTest, OtherContextsAreInstantiatedByTheirUsers)
+{
+	google::protobuf::Arena arena;
+	ForwardingContext context;
+	CoreBuffer buffer;
+	buffer.begin_msg(MSG_NEW_TURN).write<uint8_t>(1U).end_msg();
+	auto const eor = encode_one(arena, context, buffer.data() + 4U);
+	ASSERT_EQ(eor.state, EncodeOneResult::State::OK);
+	EXPECT_EQ(eor.msg->event().next_turn(), 1);
+	auto* out = google::protobuf::Arena::CreateMessage<
+		google::protobuf::RepeatedPtrField<Msg>>(&arena);
+	auto const result = encode_all(context, buffer.data(), buffer.size(), *out);
+	EXPECT_EQ(result.msgs_read, 1U);
+}
+
+} // namespace
@@ -3,10 +3,14 @@
  *
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
+#include <algorithm>
 #include <array>
 #include <gtest/gtest.h>
+#include <utility>
 #include <ygopen/client/frame.hpp>
 #include <ygopen/client/frame_limbo.hpp>
+#include <ygopen/client/value_types.hpp>
+#include <ygopen/detail/small_vector.hpp>
 
 namespace
 {
@@ -34,9 +38,34 @@ using FrameWithEmpty = YGOpen::Client::BasicFrame<Empty>;
 using LimboFrameWithInt = YGOpen::Client::LimboFrame<int>;
 using LimboFrameWithEmpty = YGOpen::Client::LimboFrame<Empty>;
 
-using FrameTypes = ::testing::Types<FrameWithInt, FrameWithEmpty,
-                                    LimboFrameWithInt, LimboFrameWithEmpty>;
-using FrameUndoTypes = ::testing::Types<LimboFrameWithInt, LimboFrameWithEmpty>;
+template<typename T>
+using SlabFrame =
+	YGOpen::Client::BasicFrame<T, YGOpen::Client::Detail::DefaultBuilder<T>,
+                               YGOpen::Client::SlabCardStorage<T, 4U>>;
+template<typename T>
+using SlabLimboFrame =
+	YGOpen::Client::LimboFrame<T, YGOpen::Client::Detail::DefaultBuilder<T>,
+                               YGOpen::Client::SlabCardStorage<T, 4U>>;
+
+// NOTE: Small capacities so that tests exercise spilling to the heap.
+template<typename T>
+using InlineFrame =
+	YGOpen::Client::BasicFrame<T, YGOpen::Client::Detail::DefaultBuilder<T>,
+                               YGOpen::Client::ListCardStorage<T>,
+                               YGOpen::Client::InlinePileStorage<T, 2U, 1U>>;
+template<typename T>
+using InlineLimboFrame =
+	YGOpen::Client::LimboFrame<T, YGOpen::Client::Detail::DefaultBuilder<T>,
+                               YGOpen::Client::ListCardStorage<T>,
+                               YGOpen::Client::InlinePileStorage<T, 2U, 1U>>;
+
+using FrameTypes =
+	::testing::Types<FrameWithInt, FrameWithEmpty, LimboFrameWithInt,
+                     LimboFrameWithEmpty, SlabFrame<int>, SlabLimboFrame<int>,
+                     InlineFrame<int>, InlineLimboFrame<int>>;
+using FrameUndoTypes =
+	::testing::Types<LimboFrameWithInt, LimboFrameWithEmpty,
+                     SlabLimboFrame<int>, InlineLimboFrame<int>>;
 TYPED_TEST_SUITE(FrameTest, FrameTypes);
 TYPED_TEST_SUITE(FrameDeathTest, FrameTypes);
 TYPED_TEST_SUITE(FrameUndoTest, FrameUndoTypes);
@@ -102,6 +131,34 @@ TYPED_TEST(FrameTest, AddingAndClearingCardsWork)
 	expect_empty(frame);
 }
 
+TYPED_TEST(FrameTest, AddingManyCardsAtOnceWorks)
+{
+	auto& frame = this->frame;
+	TypeParam one_by_one;
+	std::array<YGOpen::Client::PlaceValue, 7U> const places{{
+		{0, LOCATION_MAIN_DECK, 0U, OSEQ_INVALID},
+		{0, LOCATION_MAIN_DECK, 1U, OSEQ_INVALID},
+		{0, LOCATION_MAIN_DECK, 0U, OSEQ_INVALID},
+		{1, LOCATION_HAND, 0U, OSEQ_INVALID},
+		{0, LOCATION_MONSTER_ZONE, 2U, OSEQ_INVALID},
+		{0, LOCATION_MONSTER_ZONE, 2U, 0},
+		{1, LOCATION_HAND, 1U, OSEQ_INVALID},
+	}};
+	frame.cards_add(places.cbegin(), places.cend());
+	for(auto const& p : places)
+		one_by_one.card_add(p);
+	for(auto const& [con, loc] : {std::pair{0, LOCATION_MAIN_DECK},
+	                              std::pair{1, LOCATION_HAND}})
+	{
+		auto const c = static_cast<Controller>(con);
+		EXPECT_EQ(frame.pile(c, loc).size(), one_by_one.pile(c, loc).size());
+	}
+	EXPECT_EQ(frame.pile(CONTROLLER_0, LOCATION_MAIN_DECK).size(), 3U);
+	EXPECT_TRUE(frame.has_card(places[5]));
+	frame.cards_add(places.cend(), places.cend());
+	EXPECT_EQ(frame.pile(CONTROLLER_1, LOCATION_HAND).size(), 2U);
+}
+
 TYPED_TEST(FrameTest, AccessThroughPileObjectWorks)
 {
 	auto& frame = this->frame;
@@ -267,6 +324,23 @@ auto basic_swap_test(Frame& frame, Location loc1, bool is_mat_1, Location loc2,
 	EXPECT_EQ(c2, &frame.card(p2));
 }
 
+TYPED_TEST(FrameTest, PlaceValuesWork)
+{
+	using YGOpen::Client::PlaceValue;
+	auto& frame = this->frame;
+	PlaceValue const hand(0, LOCATION_HAND, 0U, OSEQ_INVALID);
+	PlaceValue const zone(0, LOCATION_MONSTER_ZONE, 2U, OSEQ_INVALID);
+	PlaceValue const mat(0, LOCATION_MONSTER_ZONE, 2U, 0);
+	auto* const c = &frame.card_add(hand);
+	frame.card_add(zone);
+	EXPECT_EQ(&frame.card_move(hand, mat), c);
+	EXPECT_TRUE(frame.has_card(mat));
+	EXPECT_EQ(&frame.card(mat), c);
+	EXPECT_TRUE(frame.pile(hand).empty());
+	frame.card_remove(mat);
+	EXPECT_TRUE(frame.zone(zone).materials.empty());
+}
+
 TYPED_TEST(FrameTest, PileToPileSwapWorks)
 {
 	basic_swap_test(this->frame, LOCATION_MAIN_DECK, false, LOCATION_HAND,
@@ -339,6 +413,34 @@ TYPED_TEST(FrameTest, ZoneWithOverlaySwapWorks)
 	EXPECT_EQ(co2, &frame.card(po2));
 }
 
+TYPED_TEST(FrameTest, OverlaySwapUsesOverlaySequence)
+{
+	using YGOpen::Client::PlaceValue;
+	auto& frame = this->frame;
+	// NOTE: Zone sequence and overlay sequence differ, so mixing them up
+	// swaps the wrong material.
+	PlaceValue const zone(0, LOCATION_MONSTER_ZONE, 1U, OSEQ_INVALID);
+	PlaceValue const mat0(0, LOCATION_MONSTER_ZONE, 1U, 0);
+	PlaceValue const mat1(0, LOCATION_MONSTER_ZONE, 1U, 1);
+	PlaceValue const other(1, LOCATION_SPELL_ZONE, 0U, OSEQ_INVALID);
+	PlaceValue const other_zone(1, LOCATION_MONSTER_ZONE, 4U, OSEQ_INVALID);
+	PlaceValue const other_mat(1, LOCATION_MONSTER_ZONE, 4U, 0);
+	frame.card_add(zone);
+	auto* const m0 = &frame.card_add(mat0);
+	auto* const m1 = &frame.card_add(mat1);
+	auto* const o = &frame.card_add(other);
+	frame.card_add(other_zone);
+	auto* const om = &frame.card_add(other_mat);
+	frame.card_swap(mat0, other);
+	EXPECT_EQ(&frame.card(mat0), o);
+	EXPECT_EQ(&frame.card(mat1), m1);
+	EXPECT_EQ(&frame.card(other), m0);
+	frame.card_swap(mat0, other_mat);
+	EXPECT_EQ(&frame.card(mat0), om);
+	EXPECT_EQ(&frame.card(mat1), m1);
+	EXPECT_EQ(&frame.card(other_mat), o);
+}
+
 TYPED_TEST(FrameTest, PileResizingWorks)
 {
 	auto& frame = this->frame;
@@ -542,12 +644,130 @@ TYPED_TEST(FrameUndoTest, UndoCardRemoveWorks)
 
 TYPED_TEST(FrameUndoTest, UndoPileResizeWorks)
 {
-	// TODO
+	auto& frame = this->frame;
+	YGOpen::Proto::Duel::Place p;
+	p.set_loc(LOCATION_MAIN_DECK);
+	auto const& pile = frame.pile(p);
+	frame.pile_resize(p, 6U);
+	auto const grown = pile;
+	frame.pile_resize(p, 2U);
+	// Undo the shrink, then the growth, and redo both.
+	frame.undo_pile_resize(p, 2U);
+	EXPECT_EQ(pile, grown);
+	frame.undo_pile_resize(p, 6U);
+	EXPECT_TRUE(pile.empty());
+	frame.pile_resize(p, 6U);
+	EXPECT_EQ(pile, grown);
+	frame.pile_resize(p, 2U);
+	ASSERT_EQ(pile.size(), 2U);
+	EXPECT_EQ(pile[0U], grown[0U]);
+	EXPECT_EQ(pile[1U], grown[1U]);
 }
 
 TYPED_TEST(FrameUndoTest, UndoClearWorks)
 {
-	// TODO
+	auto& frame = this->frame;
+	YGOpen::Proto::Duel::Place p;
+	p.set_loc(LOCATION_MONSTER_ZONE);
+	p.set_seq(2U);
+	p.set_oseq(OSEQ_INVALID);
+	auto const* c = &frame.card_add(p);
+	auto mat = p;
+	mat.set_oseq(0);
+	auto const* m = &frame.card_add(mat);
+	YGOpen::Proto::Duel::Place hand;
+	hand.set_loc(LOCATION_HAND);
+	frame.pile_resize(hand, 3U);
+	auto const cards = frame.pile(hand);
+	for(int i = 0; i < 2; i++)
+	{
+		frame.clear();
+		expect_empty(frame);
+		EXPECT_TRUE(frame.pile(hand).empty());
+		frame.undo_clear();
+		EXPECT_EQ(&frame.card(p), c);
+		EXPECT_EQ(&frame.card(mat), m);
+		EXPECT_EQ(frame.pile(hand), cards);
+	}
+}
+
+TYPED_TEST(FrameUndoTest, CheckpointRestoreWorks)
+{
+	auto& frame = this->frame;
+	YGOpen::Proto::Duel::Place deck;
+	deck.set_loc(LOCATION_MAIN_DECK);
+	YGOpen::Proto::Duel::Place zone;
+	zone.set_loc(LOCATION_MONSTER_ZONE);
+	zone.set_oseq(OSEQ_INVALID);
+	auto const start = frame.checkpoint();
+	frame.pile_resize(deck, 4U);
+	frame.card_add(zone);
+	auto const middle = frame.checkpoint();
+	auto const deck_cards = frame.pile(deck);
+	auto const* zone_card = &frame.card(zone);
+	frame.card_remove(zone);
+	frame.clear();
+	frame.pile_resize(deck, 1U);
+	auto const end = frame.checkpoint();
+	auto const* end_card = frame.pile(deck)[0U];
+	// Jumping backwards.
+	ASSERT_TRUE(frame.restore(middle));
+	EXPECT_EQ(frame.operation(), middle.operation());
+	EXPECT_EQ(frame.pile(deck), deck_cards);
+	EXPECT_EQ(&frame.card(zone), zone_card);
+	// Redoing from a checkpoint replays the same operations.
+	frame.card_remove(zone);
+	frame.clear();
+	expect_empty(frame);
+	frame.pile_resize(deck, 1U);
+	EXPECT_EQ(frame.pile(deck)[0U], end_card);
+	// Undoing from a checkpoint works too.
+	ASSERT_TRUE(frame.restore(start));
+	expect_empty(frame);
+	ASSERT_TRUE(frame.restore(end));
+	frame.undo_pile_resize(deck, 1U);
+	frame.undo_clear();
+	EXPECT_EQ(frame.pile(deck), deck_cards);
+	frame.undo_card_remove(zone);
+	EXPECT_EQ(&frame.card(zone), zone_card);
+}
+
+TYPED_TEST(FrameUndoTest, StaleCheckpointsAreNotRestored)
+{
+	auto& frame = this->frame;
+	YGOpen::Proto::Duel::Place deck;
+	deck.set_loc(LOCATION_MAIN_DECK);
+	YGOpen::Proto::Duel::Place zone;
+	zone.set_loc(LOCATION_MONSTER_ZONE);
+	zone.set_oseq(OSEQ_INVALID);
+	auto const start = frame.checkpoint();
+	frame.pile_resize(deck, 4U);
+	auto const middle = frame.checkpoint();
+	frame.card_add(zone);
+	auto const end = frame.checkpoint();
+	// Dropping the oldest operation makes going back before it impossible.
+	frame.set_history_limit(1U);
+	EXPECT_FALSE(frame.can_restore(start));
+	EXPECT_FALSE(frame.restore(start));
+	EXPECT_EQ(frame.operation(), end.operation());
+	EXPECT_TRUE(frame.has_card(zone));
+	// Erasing (and then recording anew) an operation makes checkpoints past
+	// it stale, even once the frame gets that far again.
+	frame.undo_card_add(zone);
+	frame.erase_history();
+	EXPECT_FALSE(frame.restore(end));
+	frame.card_add(zone);
+	EXPECT_EQ(frame.operation(), end.operation());
+	EXPECT_FALSE(frame.can_restore(end));
+	EXPECT_TRUE(frame.restore(middle));
+	EXPECT_FALSE(frame.has_card(zone));
+	EXPECT_EQ(frame.pile(deck).size(), 4U);
+	// Checkpoints taken after the rewrite are fine.
+	frame.card_add(zone);
+	auto const again = frame.checkpoint();
+	ASSERT_TRUE(frame.restore(middle));
+	EXPECT_TRUE(frame.restore(again));
+	EXPECT_TRUE(frame.has_card(zone));
 }
 
 TYPED_TEST(FrameUndoTest, UndoCardShuffleWorks)
@@ -557,7 +777,136 @@ TYPED_TEST(FrameUndoTest, UndoCardShuffleWorks)
 
 TYPED_TEST(FrameUndoTest, EraseHistoryWorks)
 {
-	// TODO
+	auto& frame = this->frame;
+	YGOpen::Proto::Duel::Place p;
+	p.set_loc(LOCATION_HAND);
+	p.set_oseq(OSEQ_INVALID);
+	frame.card_add(p);
+	frame.pile_resize(p, 3U);
+	frame.undo_pile_resize(p, 3U);
+	frame.erase_history();
+	EXPECT_EQ(frame.history_size(), 1U);
+	// New operations are recorded from the current one on.
+	frame.pile_resize(p, 2U);
+	EXPECT_EQ(frame.history_size(), 2U);
+	frame.undo_pile_resize(p, 2U);
+	frame.undo_card_add(p);
+	expect_empty(frame);
+}
+
+struct CountedCard
+{
+	static inline int alive = 0;
+
+	CountedCard() noexcept { alive++; }
+	CountedCard(CountedCard const& /*other*/) noexcept { alive++; }
+	~CountedCard() noexcept { alive--; }
+};
+
+TEST(LimboFrameTest, ForgottenCardsAreDestroyed)
+{
+	{
+		YGOpen::Client::LimboFrame<CountedCard> frame;
+		YGOpen::Proto::Duel::Place hand;
+		hand.set_loc(LOCATION_HAND);
+		hand.set_oseq(OSEQ_INVALID);
+		YGOpen::Proto::Duel::Place zone;
+		zone.set_loc(LOCATION_MONSTER_ZONE);
+		zone.set_oseq(OSEQ_INVALID);
+		frame.card_add(zone);
+		frame.pile_resize(hand, 4U);
+		frame.undo_pile_resize(hand, 4U);
+		EXPECT_EQ(CountedCard::alive, 5);
+		frame.erase_history();
+		EXPECT_EQ(CountedCard::alive, 1);
+		frame.pile_resize(hand, 2U);
+		frame.clear();
+		frame.set_history_limit(2U);
+		EXPECT_EQ(frame.history_size(), 2U);
+		EXPECT_EQ(CountedCard::alive, 3);
+		// Forgetting the clear destroys the cards it took out.
+		frame.card_add(zone);
+		frame.card_add(hand);
+		EXPECT_EQ(frame.history_size(), 2U);
+		EXPECT_EQ(CountedCard::alive, 2);
+		frame.undo_card_add(hand);
+		frame.undo_card_add(zone);
+		expect_empty(frame);
+		frame.erase_history();
+		EXPECT_EQ(frame.history_size(), 0U);
+		EXPECT_EQ(CountedCard::alive, 0);
+	}
+	EXPECT_EQ(CountedCard::alive, 0);
+}
+
+TEST(LocationIndexTest, IndicesAreDense)
+{
+	using YGOpen::Client::loc_index;
+	using YGOpen::Client::zone_index;
+	using YGOpen::Client::zone_seq_lim;
+	static_assert(loc_index(LOCATION_MAIN_DECK) == 0U);
+	static_assert(loc_index(LOCATION_EXTRA_DECK) == 4U);
+	static_assert(loc_index(LOCATION_SKILL_ZONE) == 4U);
+	static_assert(zone_seq_lim(LOCATION_PENDULUM_ZONE) == 2U);
+	std::array<bool, YGOpen::Client::Detail::ZONE_COUNT> seen{};
+	for(auto loc : LOC_ALL)
+	{
+		if(!is_zone(loc))
+			continue;
+		for(uint32_t seq = 0U; seq < zone_seq_lim(loc); seq++)
+		{
+			auto const i = zone_index(loc, seq);
+			ASSERT_LT(i, seen.size());
+			EXPECT_FALSE(seen[i]);
+			seen[i] = true;
+		}
+	}
+	EXPECT_TRUE(
+		std::all_of(seen.cbegin(), seen.cend(), [](bool b) { return b; }));
+}
+
+TEST(SlabCardStorageTest, SlotsAreReused)
+{
+	YGOpen::Client::SlabCardStorage<int, 2U> storage;
+	auto& a = storage.construct(1);
+	auto& b = storage.construct(2);
+	auto& c = storage.construct(3); // Second chunk.
+	EXPECT_EQ(a, 1);
+	EXPECT_EQ(b, 2);
+	EXPECT_EQ(c, 3);
+	auto* const b_addr = &b;
+	storage.destruct(b);
+	auto& d = storage.construct(4);
+	EXPECT_EQ(&d, b_addr);
+	EXPECT_EQ(a, 1);
+	EXPECT_EQ(c, 3);
+	EXPECT_EQ(d, 4);
+}
+
+TEST(SmallVectorTest, SpillsAndKeepsOrder)
+{
+	YGOpen::Detail::SmallVector<int, 2U> v;
+	EXPECT_EQ(v.capacity(), 2U);
+	v.push_back(1);
+	v.push_back(3);
+	v.insert(v.cbegin() + 1, 2); // Spills.
+	EXPECT_GT(v.capacity(), 2U);
+	std::array const in{4, 5};
+	v.insert(v.cend(), in.cbegin(), in.cend());
+	v.insert(v.cbegin(), v.cbegin() + 3, v.cend()); // Aliasing range.
+	ASSERT_EQ(v.size(), 7U);
+	std::array const expected{4, 5, 1, 2, 3, 4, 5};
+	EXPECT_TRUE(std::equal(v.cbegin(), v.cend(), expected.cbegin()));
+	v.erase(v.cbegin(), v.cbegin() + 2);
+	v.erase(v.cbegin() + 1);
+	ASSERT_EQ(v.size(), 4U);
+	EXPECT_EQ(v[0], 1);
+	EXPECT_EQ(v[1], 3);
+	EXPECT_EQ(v.back(), 5);
+	auto moved = std::move(v);
+	EXPECT_EQ(moved.size(), 4U);
+	EXPECT_TRUE(v.empty());
+	EXPECT_EQ(v.capacity(), 2U);
 }
 
 } // namespace
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <ygopen/client/board.hpp>
+#include <ygopen/client/board_diff.hpp>
+#include <ygopen/client/card.hpp>
+#include <ygopen/client/default_card_traits.hpp>
+#include <ygopen/client/frame.hpp>
+#include <ygopen/client/frame_cow.hpp>
+#include <ygopen/client/parse_event.hpp>
+#include <ygopen/client/value_types.hpp>
+#include <ygopen/duel/constants/phase.hpp>
+
+#include "frame_helpers.hpp"
+
+namespace
+{
+
+using namespace YGOpen::Client;
+using namespace YGOpen::Duel;
+using namespace YGOpen::Proto::Duel;
+using namespace YGOpen::Client::Test;
+
+using CardType = BasicCard<DefaultCardTraits>;
+using FrameType = CowFrame<CardType>;
+
+TEST(CowFrameTest, ClonesShareUntilModified)
+{
+	FrameType a;
+	for(uint32_t i = 0U; i < 40U; i++)
+		add_card(a, at(DECK, i), i);
+	add_card(a, HAND, 100U);
+	FrameType const b = a.clone();
+	EXPECT_EQ(&a.pile(DECK), &b.pile(DECK));
+	// Modifying a card copies it and the pile holding it, nothing else.
+	set_code(a, at(DECK, 3U), 50U);
+	EXPECT_EQ(b.card(at(DECK, 3U)).code(), 3U);
+	EXPECT_EQ(std::as_const(a).card(at(DECK, 3U)).code(), 50U);
+	EXPECT_NE(&a.pile(DECK), &b.pile(DECK));
+	EXPECT_EQ(&a.pile(HAND), &b.pile(HAND));
+	auto const& ca = std::as_const(a);
+	EXPECT_EQ(&ca.card(at(DECK, 4U)), &b.card(at(DECK, 4U)));
+	EXPECT_NE(&ca.card(at(DECK, 3U)), &b.card(at(DECK, 3U)));
+	// Moving cards around does not copy them.
+	a.card_move(at(DECK, 10U), MZONE);
+	EXPECT_EQ(&ca.card(MZONE), &b.card(at(DECK, 10U)));
+	EXPECT_EQ(b.pile(DECK).size(), 40U);
+	EXPECT_FALSE(b.has_card(MZONE));
+	a.clear();
+	EXPECT_EQ(b.card(HAND).code(), 100U);
+}
+
+TEST(CowFrameTest, BehavesLikeBasicFrame)
+{
+	std::mt19937 rng(7U);
+	auto below = [&](size_t n) -> uint32_t
+	{
+		return static_cast<uint32_t>(
+			std::uniform_int_distribution<size_t>(0U, n - 1U)(rng));
+	};
+	BasicFrame<CardType> ref;
+	FrameType cow;
+	std::vector<std::pair<FrameType, Layout>> clones;
+	for(uint32_t i = 0U; i < 2000U; i++)
+	{
+		auto const con = static_cast<Controller>(below(2U));
+		auto const pile_loc = Detail::PILE_LOCATIONS[below(5U)];
+		PlaceValue const pile{con, pile_loc, 0U, OSEQ_NONE};
+		auto const size = ref.pile(pile).size();
+		PlaceValue const zone{con, LOCATION_MONSTER_ZONE, below(7U), OSEQ_NONE};
+		bool const occupied = ref.zone(zone).card != nullptr;
+		auto const mats = ref.zone(zone).materials.size();
+		auto both = [&](auto&& f)
+		{
+			f(ref);
+			f(cow);
+		};
+		switch(below(9U))
+		{
+		case 0U:
+		{
+			auto const p = at(pile, below(size + 1U));
+			both([&](auto& f) { add_card(f, p, i); });
+			break;
+		}
+		case 1U:
+		{
+			if(occupied)
+			{
+				auto const p = at(zone, zone.seq(), below(mats + 1U));
+				both([&](auto& f) { add_card(f, p, i); });
+			}
+			else if(mats == 0U)
+			{
+				both([&](auto& f) { add_card(f, zone, i); });
+			}
+			break;
+		}
+		case 2U:
+		{
+			if(size == 0U)
+				break;
+			auto const p = at(pile, below(size));
+			both([&](auto& f) { f.card_remove(p); });
+			break;
+		}
+		case 3U:
+		{
+			if(size == 0U)
+				break;
+			auto const p = at(pile, below(size));
+			if(!occupied && mats == 0U)
+				both([&](auto& f) { f.card_move(p, zone); });
+			else if(occupied)
+				both([&](auto& f) { f.card_move(zone, p); });
+			break;
+		}
+		case 4U:
+		{
+			if(size == 0U)
+				break;
+			auto const p = at(pile, below(size));
+			both([&](auto& f) { set_code(f, p, i); });
+			break;
+		}
+		case 5U:
+		{
+			if(size < 2U)
+				break;
+			auto const a = at(pile, below(size));
+			auto const b = at(pile, below(size));
+			if(a.seq() != b.seq())
+				both([&](auto& f) { f.card_swap(a, b); });
+			break;
+		}
+		case 6U:
+		{
+			PlaceValue const to{con, Detail::PILE_LOCATIONS[below(5U)], 0U,
+			                    OSEQ_NONE};
+			if(size == 0U || to.loc() == pile.loc())
+				break;
+			auto const seq = below(size);
+			auto const count = 1U + below(size - seq);
+			auto const dst = at(to, below(ref.pile(to).size() + 1U));
+			bool const reverse = below(2U) == 0U;
+			both([&](auto& f)
+			     { f.pile_splice(at(pile, seq), count, dst, reverse); });
+			break;
+		}
+		case 7U:
+		{
+			PlaceValue const other{con, Detail::PILE_LOCATIONS[below(5U)], 0U,
+			                       OSEQ_NONE};
+			both([&](auto& f) { f.pile_swap(pile, other); });
+			break;
+		}
+		default:
+		{
+			clones.emplace_back(cow.clone(), layout(ref));
+			break;
+		}
+		}
+		ASSERT_EQ(layout(cow), layout(ref)) << "step " << i;
+	}
+	ASSERT_GT(clones.size(), 100U);
+	for(auto const& [clone, expected] : clones)
+		EXPECT_EQ(layout(clone), expected);
+}
+
+TEST(CowFrameTest, BoardsAreClonedByCopying)
+{
+	using BoardType = BasicBoard<TestBoardTraits<FrameType>>;
+	BoardType target;
+	add_card(target.frame(), MZONE, 1U);
+	add_card(target.frame(), at(MZONE, 0U, 0), 2U);
+	add_card(target.frame(), HAND, 3U);
+	target.lp(CONTROLLER_0) = 8000U;
+	BoardType a;
+	for(auto const& msg : diff(a, target))
+	{
+		if(msg.has_event())
+			parse_event(a, msg.event());
+		for(auto const& query : msg.queries())
+			static_cast<void>(parse_query(a.frame(), query));
+	}
+	EXPECT_EQ(layout(a.frame()), layout(target.frame()));
+	BoardType b = a;
+	Msg::Event event;
+	auto& op = *event.mutable_card()->mutable_move()->add_ops();
+	to_proto(MZONE, *op.mutable_old_place());
+	to_proto(at(MZONE, 3U), *op.mutable_new_place());
+	parse_event(b, event);
+	EXPECT_TRUE(b.frame().has_card(at(MZONE, 3U, 0)));
+	EXPECT_TRUE(a.frame().has_card(at(MZONE, 0U, 0)));
+	EXPECT_EQ(layout(a.frame()), layout(target.frame()));
+	EXPECT_EQ(b.lp(CONTROLLER_0), 8000U);
+}
+
+TEST(CowFrameTest, ClonesCanBeModifiedFromDifferentThreads)
+{
+	for(uint32_t round = 0U; round < 50U; round++)
+	{
+		FrameType frame;
+		for(uint32_t i = 0U; i < 8U; i++)
+			add_card(frame, at(DECK, i), i);
+		auto clone = std::make_unique<FrameType>(frame.clone());
+		// NOTE: Relaxed on purpose, the clone letting go of the pile is what
+		// must order its reads before the modifications below.
+		std::atomic<bool> done{false};
+		std::thread reader(
+			[&]()
+			{
+				uint32_t sum = 0U;
+				for(auto const* c : std::as_const(*clone).pile(DECK))
+					sum += c->code();
+				EXPECT_EQ(sum, 28U);
+				clone.reset();
+				done.store(true, std::memory_order_relaxed);
+			});
+		while(!done.load(std::memory_order_relaxed))
+			std::this_thread::yield();
+		// The pile is no longer shared, so it is modified in place.
+		auto const* before = &frame.pile(DECK);
+		frame.card_remove(at(DECK, 0U));
+		set_code(frame, at(DECK, 0U), 100U);
+		EXPECT_EQ(&frame.pile(DECK), before);
+		reader.join();
+	}
+}
+
+} // namespace
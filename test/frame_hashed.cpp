@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include <array>
+#include <gtest/gtest.h>
+#include <ygopen/client/board.hpp>
+#include <ygopen/client/card.hpp>
+#include <ygopen/client/default_card_traits.hpp>
+#include <ygopen/client/frame_hashed.hpp>
+#include <ygopen/client/packed_card_traits.hpp>
+#include <ygopen/client/value_types.hpp>
+#include <ygopen/duel/constants/phase.hpp>
+
+#include "frame_helpers.hpp"
+
+namespace
+{
+
+using namespace YGOpen::Client;
+using namespace YGOpen::Duel;
+using namespace YGOpen::Proto::Duel;
+using namespace YGOpen::Client::Test;
+
+using CardType = BasicCard<DefaultCardTraits>;
+using FrameType = HashedFrame<CardType>;
+using PackedFrameType = HashedFrame<BasicCard<PackedCardTraits>>;
+
+class HashedFrameTest : public ::testing::Test
+{
+protected:
+	FrameType frame;
+	FrameType other;
+};
+
+TEST_F(HashedFrameTest, EmptyFrameHashesToZero)
+{
+	EXPECT_EQ(frame.state_hash(), 0U);
+	add_card(frame, MZONE, 1U);
+	add_card(frame, at(MZONE, 0U, 0), 2U);
+	frame.pile_resize(DECK, 3U);
+	EXPECT_NE(frame.state_hash(), 0U);
+	frame.card_remove(at(MZONE, 0U, 0));
+	frame.card_remove(MZONE);
+	frame.pile_resize(DECK, 0U);
+	EXPECT_EQ(frame.state_hash(), 0U);
+	frame.pile_resize(DECK, 3U);
+	frame.clear();
+	EXPECT_EQ(frame.state_hash(), 0U);
+}
+
+TEST_F(HashedFrameTest, SameStateHashesTheSame)
+{
+	// Same cards reached through different operations.
+	add_card(frame, DECK, 1U);
+	add_card(frame, DECK, 2U);
+	add_card(frame, DECK, 3U);
+	frame.card_move(at(DECK, 2U), MZONE);
+	add_card(frame, at(MZONE, 0U, 0), 4U);
+	frame.card_move(MZONE, at(MZONE, 3U));
+	frame.pile_splice(DECK, 1U, HAND, false);
+	frame.card_swap(HAND, at(MZONE, 3U, 0));
+	add_card(other, HAND, 4U);
+	add_card(other, DECK, 2U);
+	add_card(other, at(MZONE, 3U), 1U);
+	add_card(other, at(MZONE, 3U, 0), 3U);
+	EXPECT_NE(frame.state_hash(), 0U);
+	EXPECT_EQ(frame.state_hash(), other.state_hash());
+	// Cards are the same, but not where they are.
+	other.pile_swap(DECK, HAND);
+	EXPECT_NE(frame.state_hash(), other.state_hash());
+	other.pile_swap(DECK, HAND);
+	EXPECT_EQ(frame.state_hash(), other.state_hash());
+	other.card_swap(at(MZONE, 3U), at(MZONE, 3U, 0));
+	EXPECT_NE(frame.state_hash(), other.state_hash());
+	other.card_swap(at(MZONE, 3U, 0), at(MZONE, 3U));
+	EXPECT_EQ(frame.state_hash(), other.state_hash());
+	EXPECT_EQ(other.card(at(MZONE, 3U)).code(), 1U);
+}
+
+TEST_F(HashedFrameTest, PileOrderIsHashed)
+{
+	add_card(frame, DECK, 1U);
+	add_card(frame, DECK, 2U);
+	add_card(other, DECK, 2U);
+	add_card(other, DECK, 1U);
+	EXPECT_NE(frame.state_hash(), other.state_hash());
+	other.card_swap(DECK, at(DECK, 1U));
+	EXPECT_EQ(frame.state_hash(), other.state_hash());
+	// Changes made between calls are seen as well.
+	frame.card_move(DECK, at(DECK, 1U));
+	other.card_move(at(DECK, 1U), DECK);
+	EXPECT_EQ(frame.state_hash(), other.state_hash());
+	frame.pile_splice(DECK, 2U, HAND, true);
+	other.pile_splice(DECK, 2U, HAND, false);
+	EXPECT_NE(frame.state_hash(), other.state_hash());
+}
+
+TEST_F(HashedFrameTest, EqualCardsDoNotCancelOut)
+{
+	frame.pile_resize(DECK, 2U);
+	other.pile_resize(DECK, 4U);
+	EXPECT_NE(frame.state_hash(), 0U);
+	EXPECT_NE(frame.state_hash(), other.state_hash());
+}
+
+TEST(HashedFrameSizeTest, PileSizesAreHashed)
+{
+	// NOTE: Every card hashing to 0 makes every sum 0 as well.
+	struct ZeroHasher
+	{
+		constexpr auto operator()(CardType const& /*c*/) const noexcept
+			-> uint64_t
+		{
+			return 0U;
+		}
+	};
+	using ZeroFrameType =
+		HashedFrame<CardType, Detail::DefaultBuilder<CardType>,
+		            ListCardStorage<CardType>, VectorPileStorage<CardType>,
+		            ZeroHasher>;
+	ZeroFrameType frame;
+	ZeroFrameType other;
+	frame.pile_resize(DECK, 2U);
+	other.pile_resize(DECK, 3U);
+	EXPECT_NE(frame.state_hash(), 0U);
+	EXPECT_NE(frame.state_hash(), other.state_hash());
+	other.card_remove(at(DECK, 1U));
+	EXPECT_EQ(frame.state_hash(), other.state_hash());
+}
+
+TEST_F(HashedFrameTest, QueriesUpdateHash)
+{
+	add_card(frame, HAND, 1U);
+	add_card(other, HAND, 2U);
+	EXPECT_NE(frame.state_hash(), other.state_hash());
+	auto q = make_query(HAND, 2U);
+	EXPECT_EQ(parse_query<true>(frame, q), QueryCacheHit::UNSPECIFIED);
+	EXPECT_EQ(frame.state_hash(), other.state_hash());
+	EXPECT_EQ(parse_query_delta(frame, q), QueryCacheHit::CODE);
+	EXPECT_EQ(frame.state_hash(), other.state_hash());
+}
+
+TEST_F(HashedFrameTest, ShuffleUpdatesHash)
+{
+	add_card(frame, at(MZONE, 0U), 1U);
+	add_card(frame, at(MZONE, 0U, 0), 2U);
+	add_card(frame, at(MZONE, 1U), 3U);
+	std::array previous{at(MZONE, 0U), at(MZONE, 1U)};
+	std::array current{at(MZONE, 2U), at(MZONE, 0U)};
+	frame.card_shuffle(previous.cbegin(), current.cbegin(), 2U);
+	add_card(other, at(MZONE, 2U), 1U);
+	add_card(other, at(MZONE, 2U, 0), 2U);
+	add_card(other, at(MZONE, 0U), 3U);
+	EXPECT_EQ(frame.state_hash(), other.state_hash());
+}
+
+TEST_F(HashedFrameTest, HashDoesNotDependOnCardTraits)
+{
+	PackedFrameType packed;
+	add_card(frame, at(MZONE, 2U), 1U);
+	add_card(frame, HAND, 2U);
+	add_card(packed, at(MZONE, 2U), 1U);
+	add_card(packed, HAND, 2U);
+	EXPECT_EQ(frame.state_hash(), packed.state_hash());
+}
+
+TEST(HashedBoardTest, StateHashCoversEveryValue)
+{
+	BasicBoard<TestBoardTraits<FrameType>> a;
+	BasicBoard<TestBoardTraits<FrameType>> b;
+	EXPECT_EQ(a.state_hash(), b.state_hash());
+	a.lp(CONTROLLER_1) = 8000U;
+	EXPECT_NE(a.state_hash(), b.state_hash());
+	b.lp(CONTROLLER_1) = 8000U;
+	EXPECT_EQ(a.state_hash(), b.state_hash());
+	a.phase() = PHASE_MAIN_1;
+	EXPECT_NE(a.state_hash(), b.state_hash());
+	b.phase() = PHASE_MAIN_1;
+	a.frame().card_add(HAND);
+	EXPECT_NE(a.state_hash(), b.state_hash());
+}
+
+} // namespace
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef YGOPEN_TEST_FRAME_HELPERS_HPP
+#define YGOPEN_TEST_FRAME_HELPERS_HPP
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <ygopen/client/frame.hpp>
+#include <ygopen/client/parse_query.hpp>
+#include <ygopen/client/state_hash.hpp>
+#include <ygopen/client/value_types.hpp>
+#include <ygopen/duel/constants/controller.hpp>
+#include <ygopen/duel/constants/location.hpp>
+#include <ygopen/duel/constants/phase.hpp>
+#include <ygopen/proto/duel/data.hpp>
+#include <ygopen/proto/duel/msg.hpp>
+
+// Places, cards and boards shared by the tests of frames and boards.
+namespace YGOpen::Client::Test
+{
+
+inline constexpr auto OSEQ_NONE = Proto::Duel::OSEQ_INVALID;
+inline constexpr PlaceValue DECK{Duel::CONTROLLER_0, Duel::LOCATION_MAIN_DECK,
+                                 0U, OSEQ_NONE};
+inline constexpr PlaceValue HAND{Duel::CONTROLLER_0, Duel::LOCATION_HAND, 0U,
+                                 OSEQ_NONE};
+inline constexpr PlaceValue MZONE{Duel::CONTROLLER_0,
+                                  Duel::LOCATION_MONSTER_ZONE, 0U, OSEQ_NONE};
+
+constexpr auto at(PlaceValue place, uint32_t seq,
+                  int32_t oseq = OSEQ_NONE) noexcept -> PlaceValue
+{
+	place.set_seq(seq);
+	place.set_oseq(oseq);
+	return place;
+}
+
+inline auto make_query(PlaceValue const& place, uint32_t code) noexcept
+	-> Proto::Duel::Msg::Query
+{
+	Proto::Duel::Msg::Query q;
+	to_proto(place, *q.mutable_place());
+	q.mutable_data()->mutable_code()->set_value(code);
+	return q;
+}
+
+template<typename Frame>
+auto set_code(Frame& frame, PlaceValue const& place, uint32_t code) noexcept
+	-> void
+{
+	static_cast<void>(parse_query(frame, make_query(place, code)));
+}
+
+template<typename Frame>
+auto add_card(Frame& frame, PlaceValue const& place, uint32_t code) noexcept
+	-> void
+{
+	frame.card_add(place);
+	set_code(frame, place, code);
+}
+
+using Layout = std::vector<std::pair<uint64_t, uint64_t>>;
+
+// Every card in order, as its place and the hash of its values.
+template<typename Frame>
+auto layout(Frame const& frame) noexcept -> Layout
+{
+	Layout cards;
+	auto add = [&](PlaceValue p, typename Frame::CardType const& c)
+	{
+		cards.emplace_back(p.key(), CardValuesHasher{}(c));
+	};
+	Detail::for_each_card(frame, add);
+	return cards;
+}
+
+template<typename Frame>
+struct TestBoardTraits
+{
+	using BlockedZonesType = std::vector<PlaceValue>;
+	using ChainStackType = std::vector<ChainValue>;
+	using FrameType = Frame;
+	using LPType = uint32_t;
+	using PhaseType = Duel::Phase;
+	using TurnControllerType = Duel::Controller;
+	using TurnType = uint32_t;
+};
+
+} // namespace YGOpen::Client::Test
+
+#endif // YGOPEN_TEST_FRAME_HELPERS_HPP
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <ygopen/detail/spsc_ring.hpp>
+#include <ygopen/proto/duel/msg.hpp>
+#include <ygopen/server/msg_pipeline.hpp>
+
+namespace
+{
+
+using namespace YGOpen::Server;
+using YGOpen::Detail::SpscRing;
+
+constexpr uint8_t MSG_WAITING = 3U;
+constexpr uint8_t MSG_NEW_TURN = 40U;
+
+// Buffer of `MSG_NEW_TURN` core messages, laid out like `OCG_DuelGetMessage`.
+auto new_turns(uint8_t first, uint8_t count) noexcept -> std::vector<uint8_t>
+{
+	std::vector<uint8_t> buffer;
+	for(uint8_t i = 0U; i < count; i++)
+	{
+		uint32_t const size = 2U;
+		auto const pos = buffer.size();
+		buffer.resize(pos + sizeof(size));
+		std::memcpy(buffer.data() + pos, &size, sizeof(size));
+		buffer.push_back(MSG_NEW_TURN);
+		buffer.push_back(static_cast<uint8_t>(first + i));
+	}
+	return buffer;
+}
+
+TEST(SpscRingTest, FillsUpAndEmpties)
+{
+	SpscRing<int> ring(3U);
+	EXPECT_EQ(ring.capacity(), 4U);
+	EXPECT_EQ(ring.front(), nullptr);
+	for(int i = 0; i < 4; i++)
+	{
+		auto* slot = ring.back();
+		ASSERT_NE(slot, nullptr);
+		*slot = i;
+		ring.push();
+	}
+	EXPECT_EQ(ring.back(), nullptr);
+	EXPECT_EQ(ring.size(), 4U);
+	EXPECT_EQ(*ring.front(), 0);
+	ring.pop();
+	ASSERT_NE(ring.back(), nullptr);
+	for(int i = 1; i < 4; i++)
+	{
+		EXPECT_EQ(*ring.front(), i);
+		ring.pop();
+	}
+	EXPECT_EQ(ring.front(), nullptr);
+}
+
+TEST(SpscRingTest, KeepsOrderAcrossThreads)
+{
+	constexpr size_t COUNT = 100000U;
+	SpscRing<size_t> ring(8U);
+	std::thread producer(
+		[&]()
+		{
+			for(size_t i = 0U; i < COUNT; i++)
+			{
+				size_t* slot = nullptr;
+				while((slot = ring.back()) == nullptr)
+					std::this_thread::yield();
+				*slot = i;
+				ring.push();
+			}
+		});
+	for(size_t i = 0U; i < COUNT; i++)
+	{
+		size_t* slot = nullptr;
+		while((slot = ring.front()) == nullptr)
+			std::this_thread::yield();
+		ASSERT_EQ(*slot, i);
+		ring.pop();
+	}
+	producer.join();
+}
+
+TEST(MsgPipelineTest, ConsumersGetEveryMessageInOrder)
+{
+	std::vector<std::pair<int, int>> got;
+	auto consumer = [&got](int id) -> MsgPipeline::Consumer
+	{
+		return [&got, id](MsgPipeline::Msg const& msg)
+		{ got.emplace_back(id, msg.event().next_turn()); };
+	};
+	{
+		MsgPipeline pipeline({consumer(0), consumer(1)}, {4U, false});
+		for(uint8_t i = 0U; i < 50U; i++)
+		{
+			auto const buffer = new_turns(i * 3U, 3U);
+			pipeline.push(buffer.data(), buffer.size());
+		}
+		pipeline.flush();
+		EXPECT_EQ(pipeline.pending(), 0U);
+		EXPECT_EQ(got.size(), 300U);
+		// Whatever is pushed before destroying the pipeline is delivered.
+		auto const buffer = new_turns(150U, 1U);
+		pipeline.push(buffer.data(), buffer.size());
+	}
+	ASSERT_EQ(got.size(), 302U);
+	for(size_t i = 0U; i < got.size(); i++)
+	{
+		EXPECT_EQ(got[i].first, static_cast<int>(i % 2U));
+		EXPECT_EQ(got[i].second, static_cast<int>(i / 2U));
+	}
+}
+
+TEST(MsgPipelineTest, FullPipelineRejectsOrWaits)
+{
+	std::atomic<bool> hold{true};
+	std::atomic<int> delivered{0};
+	auto slow = [&](MsgPipeline::Msg const& /*msg*/)
+	{
+		while(hold)
+			std::this_thread::yield();
+		delivered++;
+	};
+	MsgPipeline pipeline({slow}, {2U, false});
+	auto const buffer = new_turns(1U, 1U);
+	EXPECT_TRUE(pipeline.try_push(buffer.data(), buffer.size()));
+	EXPECT_TRUE(pipeline.try_push(buffer.data(), buffer.size()));
+	// Buffers stay in the ring until delivered, so it is full now.
+	EXPECT_FALSE(pipeline.try_push(buffer.data(), buffer.size()));
+	EXPECT_EQ(pipeline.pending(), 2U);
+	std::thread release(
+		[&]()
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			hold = false;
+		});
+	pipeline.push(buffer.data(), buffer.size());
+	pipeline.flush();
+	EXPECT_EQ(delivered, 3);
+	release.join();
+}
+
+TEST(MsgPipelineTest, DroppedMessagesAreCounted)
+{
+	int delivered = 0;
+	MsgPipeline pipeline({[&delivered](MsgPipeline::Msg const& /*msg*/)
+	                      { delivered++; }});
+	auto buffer = new_turns(1U, 2U);
+	// NOTE: Not known by the encoder.
+	buffer[sizeof(uint32_t)] = MSG_WAITING;
+	pipeline.push(buffer.data(), buffer.size());
+	// Last message is cut short.
+	pipeline.push(buffer.data(), buffer.size() - 1U);
+	pipeline.flush();
+	auto const stats = pipeline.stats();
+	EXPECT_EQ(stats.unknown_msgs, 2U);
+	EXPECT_EQ(stats.malformed_msgs, 0U);
+	EXPECT_EQ(stats.truncated_buffers, 1U);
+	EXPECT_EQ(delivered, 1);
+}
+
+} // namespace
@@ -3,13 +3,17 @@
  *
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <ygopen/client/board.hpp>
+#include <ygopen/client/event_seeker.hpp>
+#include <ygopen/client/frame.hpp>
 #include <ygopen/client/frame_limbo.hpp>
 #include <ygopen/client/parse_event.hpp>
 #include <ygopen/client/undo_parse_event.hpp>
 #include <ygopen/client/undoable.hpp>
 #include <ygopen/proto/duel/msg.hpp>
+#include <vector>
 
 namespace
 {
@@ -29,6 +33,33 @@ struct TestBoardTraits // TODO: Undoable values.
 	using TurnType = BasicUndoable<uint32_t>;
 };
 
+// Frame written before frames had `cards_add`.
+class CardAddOnlyFrame : private BasicFrame<int>
+{
+public:
+	using BasicFrame<int>::card_add;
+	using BasicFrame<int>::card_move;
+	using BasicFrame<int>::card_remove;
+	using BasicFrame<int>::card_shuffle;
+	using BasicFrame<int>::card_swap;
+	using BasicFrame<int>::clear;
+	using BasicFrame<int>::pile;
+	using BasicFrame<int>::pile_resize;
+	using BasicFrame<int>::pile_splice;
+	using BasicFrame<int>::pile_swap;
+};
+
+struct CardAddOnlyBoardTraits
+{
+	using BlockedZonesType = std::vector<Place>;
+	using ChainStackType = std::vector<Chain>;
+	using FrameType = CardAddOnlyFrame;
+	using LPType = uint32_t;
+	using PhaseType = Phase;
+	using TurnControllerType = Controller;
+	using TurnType = uint32_t;
+};
+
 class ParseEventTest : public ::testing::Test
 {
 protected:
@@ -53,4 +84,58 @@ TEST_F(ParseEventTest, BoardStateWorks)
 	undo_parse_event(b, e);
 }
 
+TEST(ParseEventFrameTest, FramesWithoutCardsAddWork)
+{
+	BasicBoard<CardAddOnlyBoardTraits> b;
+	Msg::Event e;
+	auto& add = *e.mutable_board()->mutable_exchange()->mutable_add();
+	for(uint32_t seq = 0U; seq < 3U; seq++)
+	{
+		auto& place = *add.add_places();
+		place.set_loc(LOCATION_HAND);
+		place.set_seq(seq);
+		place.set_oseq(OSEQ_INVALID);
+	}
+	parse_event(b, e);
+	EXPECT_EQ(b.frame().pile(CONTROLLER_0, LOCATION_HAND).size(), 3U);
+}
+
+TEST(EventSeekerTest, SeekingWorks)
+{
+	BasicBoard<TestBoardTraits> b;
+	BasicEventSeeker<BasicBoard<TestBoardTraits>> seeker(b, 4U);
+	// Even events add a card to the hand, odd ones set the LP to their index.
+	constexpr uint32_t EVENT_COUNT = 41U;
+	std::vector<Msg::Event> events(EVENT_COUNT);
+	for(uint32_t i = 0U; i < EVENT_COUNT; i++)
+	{
+		auto& e = events[i];
+		if(i % 2U == 0U)
+		{
+			auto& place = *e.mutable_card()->mutable_add()->add_places();
+			place.set_loc(LOCATION_HAND);
+			place.set_seq(i / 2U);
+			place.set_oseq(OSEQ_INVALID);
+		}
+		else
+		{
+			e.mutable_lp()->set_controller(CONTROLLER_0);
+			e.mutable_lp()->set_become(i);
+		}
+		seeker.parse(e);
+	}
+	ASSERT_EQ(seeker.size(), EVENT_COUNT);
+	auto const hand = b.frame().pile(CONTROLLER_0, LOCATION_HAND);
+	for(uint32_t index : {7U, 40U, 0U, 41U, 3U, 24U, 24U, 25U, 1U})
+	{
+		seeker.seek_to(events, index);
+		EXPECT_EQ(seeker.position(), index);
+		auto const& pile = b.frame().pile(CONTROLLER_0, LOCATION_HAND);
+		ASSERT_EQ(pile.size(), (index + 1U) / 2U);
+		EXPECT_TRUE(std::equal(pile.cbegin(), pile.cend(), hand.cbegin()));
+		auto const lp = (index < 2U) ? 0U : index - 1U - (index % 2U);
+		EXPECT_EQ(uint32_t{b.lp(CONTROLLER_0)}, lp);
+	}
+}
+
 } // namespace
@@ -5,7 +5,13 @@
  */
 #include <gtest/gtest.h>
 #include <ygopen/client/card.hpp>
+#include <ygopen/client/default_card_traits.hpp>
+#include <ygopen/client/packed_card_traits.hpp>
 #include <ygopen/client/parse_query.hpp>
+#include <ygopen/duel/constants/link_arrow.hpp>
+#include <ygopen/duel/constants/location.hpp>
+#include <ygopen/duel/constants/position.hpp>
+#include <ygopen/duel/constants/race.hpp>
 
 namespace
 {
@@ -672,4 +678,123 @@ TEST_F(ParseQueryTest, LinkArrowSettingWorks)
 	ASSERT_EQ(hits, YGOpen::Client::QueryCacheHit::UNSPECIFIED);
 }
 
+TEST_F(ParseQueryTest, CountersSettingWorks)
+{
+	ASSERT_TRUE(f.c.counters().empty());
+	auto& counter = *q.mutable_data()->mutable_counters()->add_values();
+	counter.set_type(VALUE1);
+	counter.set_count(3U);
+	hits = YGOpen::Client::parse_query(f, q);
+	ASSERT_EQ(f.c.counters().size(), 1U);
+	ASSERT_EQ(f.c.counters()[0].count(), 3U);
+	ASSERT_EQ(hits, YGOpen::Client::QueryCacheHit::UNSPECIFIED);
+	// Check that cache is hit when use_cache=true
+	hits = YGOpen::Client::parse_query<true>(f, q);
+	ASSERT_EQ(hits, YGOpen::Client::QueryCacheHit::COUNTERS);
+	// Check that cache is not hit when use_cache=true
+	q.mutable_data()->mutable_counters()->mutable_values(0)->set_count(2U);
+	hits = YGOpen::Client::parse_query<true>(f, q);
+	ASSERT_EQ(f.c.counters()[0].count(), 2U);
+	ASSERT_EQ(hits, YGOpen::Client::QueryCacheHit::UNSPECIFIED);
+}
+
+TEST_F(ParseQueryTest, DeltaRemovesCachedValues)
+{
+	auto& data = *q.mutable_data();
+	data.mutable_atk()->set_value(VALUE1);
+	data.mutable_def()->set_value(VALUE1);
+	data.mutable_counters()->add_values()->set_type(VALUE1);
+	static_cast<void>(YGOpen::Client::parse_query(f, q));
+	data.mutable_def()->set_value(VALUE2);
+	hits = YGOpen::Client::parse_query_delta(f, q);
+	ASSERT_FALSE(data.has_atk());
+	ASSERT_FALSE(data.has_counters());
+	ASSERT_TRUE(data.has_def());
+	ASSERT_EQ(f.c.def(), VALUE2);
+	ASSERT_FALSE(!(hits & YGOpen::Client::QueryCacheHit::ATTACK));
+	ASSERT_TRUE(!(hits & YGOpen::Client::QueryCacheHit::DEFENSE));
+}
+
+class PackedTestFrame
+{
+public:
+	using CardType =
+		YGOpen::Client::BasicCard<YGOpen::Client::PackedCardTraits>;
+	CardType c;
+
+	auto card(YGOpen::Proto::Duel::Place const& /*p*/) noexcept -> CardType&
+	{
+		return c;
+	}
+
+	auto has_card(YGOpen::Proto::Duel::Place const& /*p*/) noexcept -> bool
+	{
+		return true;
+	}
+};
+
+TEST(PackedCardTraitsTest, IsDropInForParseQuery)
+{
+	using YGOpen::Client::QueryCacheHit;
+	static_assert(
+		sizeof(PackedTestFrame::CardType) * 3U <=
+		sizeof(YGOpen::Client::BasicCard<YGOpen::Client::DefaultCardTraits>) *
+			2U);
+	PackedTestFrame f;
+	YGOpen::Proto::Duel::Msg::Query q;
+	auto& data = *q.mutable_data();
+	data.mutable_level()->set_value(12);
+	data.mutable_position()->set_value(YGOpen::Duel::POSITION_FACE_UP_ATTACK);
+	data.mutable_race()->set_value(YGOpen::Duel::RACE_GALAXY);
+	data.mutable_link_arrow()->set_value(YGOpen::Duel::LINK_ARROW_TOP_RIGHT);
+	auto& target = *data.mutable_targets()->add_values();
+	target.set_loc(YGOpen::Duel::LOCATION_MONSTER_ZONE);
+	target.set_seq(2U);
+	data.mutable_targets()->add_values()->set_seq(3U); // Spills.
+	data.mutable_counters()->add_values()->set_count(4U);
+	auto hits = YGOpen::Client::parse_query(f, q);
+	ASSERT_EQ(hits, QueryCacheHit::UNSPECIFIED);
+	EXPECT_EQ(f.c.level(), 12);
+	EXPECT_EQ(f.c.position(), YGOpen::Duel::POSITION_FACE_UP_ATTACK);
+	EXPECT_EQ(f.c.race(), YGOpen::Duel::RACE_GALAXY);
+	EXPECT_EQ(f.c.link_arrow(), YGOpen::Duel::LINK_ARROW_TOP_RIGHT);
+	ASSERT_EQ(f.c.targets().size(), 2U);
+	EXPECT_EQ(f.c.targets()[0].seq(), 2U);
+	EXPECT_EQ(f.c.targets()[1].seq(), 3U);
+	ASSERT_EQ(f.c.counters().size(), 1U);
+	EXPECT_EQ(f.c.counters()[0].count(), 4U);
+	hits = YGOpen::Client::parse_query<true>(f, q);
+	EXPECT_FALSE(!(hits & QueryCacheHit::LEVEL));
+	EXPECT_FALSE(!(hits & QueryCacheHit::TARGET_CARD));
+	EXPECT_FALSE(!(hits & QueryCacheHit::COUNTERS));
+}
+
+TEST(PackedCardTraitsTest, OutOfRangeValuesSaturate)
+{
+	PackedTestFrame f;
+	YGOpen::Proto::Duel::Msg::Query q;
+	auto& data = *q.mutable_data();
+	data.mutable_level()->set_value(200);
+	data.mutable_xyz_rank()->set_value(0x1FFU);
+	data.mutable_pend_l_scale()->set_value(0xFFFFFFFFU);
+	static_cast<void>(YGOpen::Client::parse_query(f, q));
+	EXPECT_EQ(f.c.level(), 127);
+	EXPECT_EQ(f.c.xyz_rank(), 255U);
+	EXPECT_EQ(f.c.pend_l_scale(), 255U);
+	data.mutable_level()->set_value(-200);
+	static_cast<void>(YGOpen::Client::parse_query(f, q));
+	EXPECT_EQ(f.c.level(), -128);
+}
+
+TEST(PackedCardTraitsTest, RacesPast32BitsAreKept)
+{
+	auto const race = static_cast<YGOpen::Duel::Race>(
+		static_cast<uint64_t>(YGOpen::Duel::RACE_GALAXY) << 1U);
+	PackedTestFrame f;
+	YGOpen::Proto::Duel::Msg::Query q;
+	q.mutable_data()->mutable_race()->set_value(race);
+	static_cast<void>(YGOpen::Client::parse_query(f, q));
+	EXPECT_EQ(f.c.race(), race);
+}
+
 } // namespace
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 #include <gtest/gtest.h>
+#include <unordered_set>
+#include <ygopen/client/value_types.hpp>
 #include <ygopen/proto/duel/data.hpp>
 
 namespace
@@ -58,4 +60,85 @@ TEST(PlaceTest, PlaceLessWorks)
 
 // TODO: Test operator== from <ygopen/proto/duel/data.hpp>
 
+TEST(PlaceValueTest, ConversionRoundTrips)
+{
+	using YGOpen::Client::PlaceValue;
+	Place p;
+	p.set_con(1);
+	p.set_loc(YGOpen::Duel::LOCATION_MONSTER_ZONE);
+	p.set_seq(4);
+	p.set_oseq(OSEQ_INVALID);
+	PlaceValue const value(p);
+	EXPECT_EQ(value.con(), p.con());
+	EXPECT_EQ(value.loc(), p.loc());
+	EXPECT_EQ(value.seq(), p.seq());
+	EXPECT_EQ(value.oseq(), p.oseq());
+	EXPECT_TRUE(is_zone(value));
+	Place back;
+	to_proto(value, back);
+	EXPECT_EQ(back, p);
+}
+
+TEST(PlaceValueTest, OutOfRangePlacesAreEmpty)
+{
+	using YGOpen::Client::PlaceValue;
+	Place p;
+	p.set_con(1);
+	p.set_loc(YGOpen::Duel::LOCATION_MAIN_DECK);
+	p.set_seq(0x10003U);
+	p.set_oseq(OSEQ_INVALID);
+	// NOTE: Would be the 4th card of the deck if `seq` was truncated.
+	PlaceValue value(p);
+	EXPECT_TRUE(is_empty(value));
+	EXPECT_EQ(value, PlaceValue{});
+	p.set_seq(3U);
+	p.set_oseq(0x8000);
+	EXPECT_TRUE(is_empty(PlaceValue(p)));
+	p.set_oseq(OSEQ_INVALID);
+	value = p;
+	EXPECT_FALSE(is_empty(value));
+	value.set_con(0x100);
+	EXPECT_TRUE(is_empty(value));
+}
+
+TEST(PlaceValueTest, KeyOrdersLikePlaceLess)
+{
+	using YGOpen::Client::PlaceValue;
+	Place p1;
+	Place p2;
+	auto expect_same_order = [&]()
+	{
+		PlaceValue const v1(p1);
+		PlaceValue const v2(p2);
+		EXPECT_EQ(PlaceLess{}(p1, p2), v1 < v2);
+		EXPECT_EQ(PlaceLess{}(p2, p1), v2 < v1);
+		EXPECT_EQ(p1 == p2, v1 == v2);
+	};
+	expect_same_order();
+	p1.set_con(1);
+	expect_same_order();
+	p2.set_loc(YGOpen::Duel::LOCATION_SKILL_ZONE);
+	expect_same_order();
+	p1 = p2;
+	p1.set_seq(3);
+	expect_same_order();
+	p2.set_seq(3);
+	p2.set_oseq(OSEQ_INVALID);
+	expect_same_order();
+	p1.set_oseq(2);
+	expect_same_order();
+}
+
+TEST(PlaceValueTest, HashingWorks)
+{
+	using YGOpen::Client::PlaceValue;
+	std::unordered_set<PlaceValue> set;
+	set.emplace(0, YGOpen::Duel::LOCATION_HAND, 0U, OSEQ_INVALID);
+	set.emplace(0, YGOpen::Duel::LOCATION_HAND, 1U, OSEQ_INVALID);
+	set.emplace(0, YGOpen::Duel::LOCATION_HAND, 0U, OSEQ_INVALID);
+	EXPECT_EQ(set.size(), 2U);
+	EXPECT_EQ(set.count({0, YGOpen::Duel::LOCATION_HAND, 1U, OSEQ_INVALID}),
+	          1U);
+}
+
 } // namespace
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include <gtest/gtest.h>
+#include <vector>
+#include <ygopen/client/card.hpp>
+#include <ygopen/client/default_card_traits.hpp>
+#include <ygopen/client/frame_limbo.hpp>
+#include <ygopen/client/query_journal.hpp>
+
+namespace
+{
+
+using namespace YGOpen::Duel;
+using namespace YGOpen::Proto::Duel;
+
+using CardType = YGOpen::Client::BasicCard<YGOpen::Client::DefaultCardTraits>;
+using FrameType = YGOpen::Client::LimboFrame<CardType>;
+using JournalType = YGOpen::Client::BasicQueryJournal<CardType>;
+
+class QueryJournalTest : public ::testing::Test
+{
+protected:
+	FrameType frame;
+	JournalType journal;
+	Place a;
+	Place b;
+
+	auto SetUp() -> void override
+	{
+		a.set_loc(LOCATION_MONSTER_ZONE);
+		a.set_oseq(OSEQ_INVALID);
+		b = a;
+		b.set_seq(1U);
+		frame.card_add(a);
+		frame.card_add(b);
+	}
+
+	static auto make_query(Place const& place, uint32_t code,
+	                       int32_t atk) noexcept -> Msg::Query
+	{
+		Msg::Query q;
+		*q.mutable_place() = place;
+		q.mutable_data()->mutable_code()->set_value(code);
+		q.mutable_data()->mutable_atk()->set_value(atk);
+		return q;
+	}
+};
+
+TEST_F(QueryJournalTest, OnlyChangedValuesAreRecorded)
+{
+	static_cast<void>(journal.parse(frame, make_query(a, 1U, 100)));
+	EXPECT_EQ(journal.history_size(), 2U);
+	auto const hits = journal.parse(frame, make_query(a, 1U, 200));
+	EXPECT_EQ(hits, YGOpen::Client::QueryCacheHit::CODE);
+	EXPECT_EQ(journal.history_size(), 3U);
+	EXPECT_EQ(journal.size(), 2U);
+}
+
+TEST_F(QueryJournalTest, UndoAndRedoWork)
+{
+	auto const& card = frame.card(a);
+	static_cast<void>(journal.parse(frame, make_query(a, 1U, 100)));
+	static_cast<void>(journal.parse(frame, make_query(a, 1U, 200)));
+	journal.undo();
+	EXPECT_EQ(card.code(), 1U);
+	EXPECT_EQ(card.atk(), 100);
+	journal.undo();
+	EXPECT_EQ(card.code(), 0U);
+	EXPECT_EQ(card.atk(), 0);
+	journal.redo();
+	EXPECT_EQ(card.code(), 1U);
+	EXPECT_EQ(card.atk(), 100);
+	journal.redo();
+	EXPECT_EQ(card.atk(), 200);
+	EXPECT_EQ(journal.position(), 2U);
+}
+
+TEST_F(QueryJournalTest, StepsCoverAllTheirQueries)
+{
+	std::vector<Msg::Query> queries{make_query(a, 1U, 100),
+	                                make_query(b, 2U, 300),
+	                                make_query(a, 3U, 100)};
+	auto* counter = queries[1U].mutable_data()->mutable_counters();
+	counter->add_values()->set_count(4U);
+	journal.parse(frame, queries);
+	EXPECT_EQ(journal.size(), 1U);
+	EXPECT_EQ(frame.card(a).code(), 3U);
+	EXPECT_EQ(frame.card(b).counters().size(), 1U);
+	journal.undo();
+	EXPECT_EQ(frame.card(a).code(), 0U);
+	EXPECT_EQ(frame.card(a).atk(), 0);
+	EXPECT_EQ(frame.card(b).code(), 0U);
+	EXPECT_TRUE(frame.card(b).counters().empty());
+	journal.redo();
+	EXPECT_EQ(frame.card(a).code(), 3U);
+	EXPECT_EQ(frame.card(b).atk(), 300);
+	EXPECT_EQ(frame.card(b).counters().size(), 1U);
+}
+
+TEST_F(QueryJournalTest, ParsingForgetsUndoneSteps)
+{
+	static_cast<void>(journal.parse(frame, make_query(a, 1U, 100)));
+	static_cast<void>(journal.parse(frame, make_query(a, 2U, 200)));
+	journal.undo();
+	static_cast<void>(journal.parse(frame, make_query(b, 3U, 300)));
+	EXPECT_EQ(journal.size(), 2U);
+	EXPECT_EQ(journal.history_size(), 4U);
+	journal.undo();
+	journal.undo();
+	EXPECT_EQ(frame.card(a).code(), 0U);
+	EXPECT_EQ(frame.card(b).code(), 0U);
+}
+
+} // namespace
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include <gtest/gtest.h>
+#include <ygopen/server/basic_encode_context.hpp>
+#include <ygopen/server/slim_encode_context.hpp>
+
+namespace
+{
+
+using namespace YGOpen::Duel;
+using namespace YGOpen::Proto::Duel;
+
+auto make_place(Controller con, Location loc, uint32_t seq,
+                int32_t oseq = OSEQ_INVALID) noexcept -> Place
+{
+	Place p;
+	p.set_con(con);
+	p.set_loc(loc);
+	p.set_seq(seq);
+	p.set_oseq(oseq);
+	return p;
+}
+
+class SlimEncodeContextTest : public ::testing::Test
+{
+protected:
+	YGOpen::Server::BasicEncodeContext basic;
+	YGOpen::Server::SlimEncodeContext slim;
+
+	auto parse(Msg msg) noexcept -> void
+	{
+		Msg copy = msg;
+		static_cast<void>(basic.parse(copy));
+		static_cast<void>(slim.parse(msg));
+	}
+
+	auto move(Place const& from, Place const& to) noexcept -> void
+	{
+		Msg msg;
+		auto& card = *msg.mutable_event()->mutable_card();
+		auto& op = *card.mutable_move()->add_ops();
+		*op.mutable_old_place() = from;
+		*op.mutable_new_place() = to;
+		parse(msg);
+	}
+
+	auto expect_same() const noexcept -> void
+	{
+		for(auto con : {CONTROLLER_0, CONTROLLER_1})
+		{
+			for(auto loc : {LOCATION_MAIN_DECK, LOCATION_HAND,
+			                LOCATION_GRAVEYARD, LOCATION_BANISHED,
+			                LOCATION_EXTRA_DECK})
+				EXPECT_EQ(slim.pile_size(con, loc), basic.pile_size(con, loc));
+			for(uint32_t seq = 0U; seq < 7U; seq++)
+			{
+				auto const p = make_place(con, LOCATION_MONSTER_ZONE, seq);
+				EXPECT_EQ(slim.has_xyz_mat(p), basic.has_xyz_mat(p));
+			}
+		}
+	}
+};
+
+TEST_F(SlimEncodeContextTest, TracksSameCountsAsBasic)
+{
+	{
+		Msg msg;
+		auto& state = *msg.mutable_event()->mutable_board()->mutable_state();
+		state.add_lps(8000U);
+		state.add_lps(8000U);
+		auto& op = *state.mutable_resize()->add_ops();
+		*op.mutable_place() = make_place(CONTROLLER_0, LOCATION_MAIN_DECK, 0U);
+		op.set_count(10U);
+		parse(msg);
+	}
+	expect_same();
+	EXPECT_EQ(slim.pile_size(CONTROLLER_0, LOCATION_MAIN_DECK), 10U);
+	// Summon a monster and attach a material to it.
+	move(make_place(CONTROLLER_0, LOCATION_MAIN_DECK, 9U),
+	     make_place(CONTROLLER_0, LOCATION_MONSTER_ZONE, 0U));
+	move(make_place(CONTROLLER_0, LOCATION_MAIN_DECK, 8U),
+	     make_place(CONTROLLER_0, LOCATION_MONSTER_ZONE, 0U, 0));
+	expect_same();
+	EXPECT_TRUE(slim.has_xyz_mat(
+		make_place(CONTROLLER_0, LOCATION_MONSTER_ZONE, 0U)));
+	// Materials follow the monster.
+	move(make_place(CONTROLLER_0, LOCATION_MONSTER_ZONE, 0U),
+	     make_place(CONTROLLER_0, LOCATION_MONSTER_ZONE, 2U));
+	expect_same();
+	EXPECT_TRUE(slim.has_xyz_mat(
+		make_place(CONTROLLER_0, LOCATION_MONSTER_ZONE, 2U)));
+	// Detach to graveyard.
+	move(make_place(CONTROLLER_0, LOCATION_MONSTER_ZONE, 2U, 0),
+	     make_place(CONTROLLER_0, LOCATION_GRAVEYARD, 0U));
+	expect_same();
+	{
+		Msg msg;
+		auto& pile = *msg.mutable_event()->mutable_pile();
+		auto& op = *pile.mutable_splice()->add_ops();
+		*op.mutable_from() = make_place(CONTROLLER_0, LOCATION_MAIN_DECK, 3U);
+		op.set_count(5U);
+		*op.mutable_to() = make_place(CONTROLLER_1, LOCATION_HAND, 0U);
+		parse(msg);
+	}
+	expect_same();
+	EXPECT_EQ(slim.pile_size(CONTROLLER_1, LOCATION_HAND), 5U);
+}
+
+TEST_F(SlimEncodeContextTest, XyzLeftWorks)
+{
+	auto const left = make_place(CONTROLLER_1, LOCATION_GRAVEYARD, 4U);
+	auto const from = make_place(CONTROLLER_1, LOCATION_MONSTER_ZONE, 3U);
+	slim.xyz_left(left, from);
+	EXPECT_EQ(slim.get_xyz_left(left), from);
+	slim.xyz_left(left, Place{});
+	EXPECT_EQ(slim.get_xyz_left(left), Place{});
+}
+
+} // namespace
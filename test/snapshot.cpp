@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2025, Dylam De La Torre <dyxel04@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+#include <ygopen/client/board.hpp>
+#include <ygopen/client/card.hpp>
+#include <ygopen/client/default_card_traits.hpp>
+#include <ygopen/client/frame.hpp>
+#include <ygopen/client/frame_hashed.hpp>
+#include <ygopen/client/packed_card_traits.hpp>
+#include <ygopen/client/snapshot.hpp>
+#include <ygopen/client/value_types.hpp>
+#include <ygopen/duel/constants/phase.hpp>
+#include <ygopen/duel/constants/position.hpp>
+#include <ygopen/duel/constants/race.hpp>
+
+#include "frame_helpers.hpp"
+
+namespace
+{
+
+using namespace YGOpen::Client;
+using namespace YGOpen::Duel;
+using namespace YGOpen::Proto::Duel;
+using YGOpen::Client::Test::at;
+using YGOpen::Client::Test::DECK;
+using YGOpen::Client::Test::OSEQ_NONE;
+using YGOpen::Client::Test::TestBoardTraits;
+
+using CardType = BasicCard<DefaultCardTraits>;
+using PackedCardType = BasicCard<PackedCardTraits>;
+using State = RestoreSnapshotResult::State;
+
+using BoardType = BasicBoard<TestBoardTraits<HashedFrame<CardType>>>;
+using PackedBoardType =
+	BasicBoard<TestBoardTraits<HashedFrame<PackedCardType>>>;
+
+constexpr PlaceValue HAND{CONTROLLER_1, LOCATION_HAND, 0U, OSEQ_NONE};
+constexpr PlaceValue MZONE{CONTROLLER_0, LOCATION_MONSTER_ZONE, 2U, OSEQ_NONE};
+constexpr PlaceValue MATERIAL{CONTROLLER_0, LOCATION_MONSTER_ZONE, 2U, 0};
+constexpr PlaceValue SZONE{CONTROLLER_1, LOCATION_SPELL_ZONE, 1U, OSEQ_NONE};
+
+template<typename Frame>
+auto fill_card(Frame& frame, PlaceValue const& place, uint32_t code) noexcept
+	-> void
+{
+	Msg::Query q;
+	to_proto(place, *q.mutable_place());
+	auto& data = *q.mutable_data();
+	data.mutable_code()->set_value(code);
+	data.mutable_position()->set_value(POSITION_FACE_UP_ATTACK);
+	data.mutable_level()->set_value(-3);
+	data.mutable_race()->set_value(RACE_CYBERSE);
+	data.mutable_atk()->set_value(-2);
+	data.mutable_is_public()->set_value(true);
+	data.mutable_owner()->set_value(CONTROLLER_1);
+	to_proto(MZONE, *data.mutable_equipped_to()->mutable_value());
+	to_proto(SZONE, *data.mutable_targets()->add_values());
+	to_proto(DECK, *data.mutable_targets()->add_values());
+	auto& counter = *data.mutable_counters()->add_values();
+	counter.set_type(0x1001U);
+	counter.set_count(code);
+	static_cast<void>(parse_query(frame, q));
+}
+
+template<typename Board>
+auto fill_board(Board& b) noexcept -> void
+{
+	auto& f = b.frame();
+	f.pile_resize(DECK, 40U);
+	fill_card(f, at(DECK, 7U), 10U);
+	f.card_add(HAND);
+	fill_card(f, HAND, 11U);
+	f.card_add(MZONE);
+	fill_card(f, MZONE, 12U);
+	f.card_add(MATERIAL);
+	f.card_add(MATERIAL);
+	fill_card(f, MATERIAL, 13U);
+	f.card_add(SZONE);
+	b.turn() = 5U;
+	b.turn_controller() = CONTROLLER_1;
+	b.phase() = PHASE_MAIN_2;
+	b.lp(CONTROLLER_0) = 8000U;
+	b.lp(CONTROLLER_1) = 1234U;
+	b.chain_stack().push_back(ChainValue{MZONE, SZONE, {12U, 1U}});
+	b.chain_stack().push_back(ChainValue{HAND, HAND, {11U, 0U}});
+	b.blocked_zones().push_back(SZONE);
+}
+
+TEST(SnapshotTest, RoundTripRestoresEverything)
+{
+	BoardType a;
+	fill_board(a);
+	auto const snapshot = take_snapshot(a);
+	BoardType b;
+	b.frame().pile_resize(HAND, 3U);
+	b.lp(CONTROLLER_0) = 1U;
+	auto const result = restore_snapshot(b, snapshot.data(), snapshot.size());
+	ASSERT_EQ(result.state, State::OK);
+	EXPECT_EQ(result.bytes_read, snapshot.size());
+	EXPECT_EQ(a.state_hash(), b.state_hash());
+	EXPECT_EQ(b.frame().pile(DECK).size(), 40U);
+	EXPECT_EQ(b.frame().pile(HAND).size(), 1U);
+	EXPECT_EQ(b.frame().zone(MZONE).materials.size(), 2U);
+	auto const& card = b.frame().card(MATERIAL);
+	EXPECT_EQ(card.code(), 13U);
+	EXPECT_EQ(card.level(), -3);
+	EXPECT_EQ(card.race(), RACE_CYBERSE);
+	EXPECT_EQ(card.owner(), CONTROLLER_1);
+	EXPECT_TRUE(card.is_public());
+	EXPECT_EQ(card.equipped_to(), MZONE);
+	ASSERT_EQ(card.targets().size(), 2U);
+	EXPECT_EQ(card.targets()[1], DECK);
+	ASSERT_EQ(card.counters().size(), 1U);
+	EXPECT_EQ(card.counters()[0].count(), 13U);
+	EXPECT_EQ(b.chain_stack(), a.chain_stack());
+	EXPECT_EQ(b.blocked_zones(), a.blocked_zones());
+	EXPECT_EQ(b.turn_controller(), CONTROLLER_1);
+	EXPECT_EQ(b.phase(), PHASE_MAIN_2);
+	// Snapshots of equal states are byte-for-byte equal.
+	EXPECT_EQ(take_snapshot(b), snapshot);
+}
+
+TEST(SnapshotTest, SnapshotsDoNotDependOnCardTraits)
+{
+	BoardType a;
+	fill_board(a);
+	auto const snapshot = take_snapshot(a);
+	PackedBoardType b;
+	auto const result = restore_snapshot(b, snapshot.data(), snapshot.size());
+	ASSERT_EQ(result.state, State::OK);
+	EXPECT_EQ(a.state_hash(), b.state_hash());
+	EXPECT_EQ(take_snapshot(b), snapshot);
+}
+
+TEST(SnapshotTest, FramesCanBeSnapshottedAlone)
+{
+	BoardType a;
+	fill_board(a);
+	BasicFrame<CardType> frame;
+	auto const snapshot = take_snapshot(a.frame());
+	auto const result =
+		restore_snapshot(frame, snapshot.data(), snapshot.size());
+	ASSERT_EQ(result.state, State::OK);
+	EXPECT_EQ(frame.card(HAND).code(), 11U);
+	EXPECT_EQ(take_snapshot(frame), snapshot);
+}
+
+TEST(SnapshotTest, RestoreWorksOnUnalignedData)
+{
+	BoardType a;
+	fill_board(a);
+	auto const snapshot = take_snapshot(a);
+	std::vector<std::byte> unaligned(snapshot.size() + 1U);
+	std::copy(snapshot.cbegin(), snapshot.cend(), unaligned.begin() + 1);
+	BoardType b;
+	auto const result =
+		restore_snapshot(b, unaligned.data() + 1, snapshot.size());
+	ASSERT_EQ(result.state, State::OK);
+	EXPECT_EQ(a.state_hash(), b.state_hash());
+}
+
+TEST(SnapshotTest, BadSnapshotsLeaveBoardUntouched)
+{
+	BoardType a;
+	fill_board(a);
+	auto const snapshot = take_snapshot(a);
+	BoardType b;
+	b.frame().card_add(HAND);
+	auto const hash = b.state_hash();
+	auto restore = [&](std::vector<std::byte> const& s, size_t size)
+	{
+		auto const result = restore_snapshot(b, s.data(), size);
+		EXPECT_EQ(b.state_hash(), hash);
+		return result.state;
+	};
+	EXPECT_EQ(restore(snapshot, 10U), State::TRUNCATED);
+	EXPECT_EQ(restore(snapshot, snapshot.size() - 1U), State::TRUNCATED);
+	auto bad = snapshot;
+	bad[0] ^= std::byte{0xFFU};
+	EXPECT_EQ(restore(bad, bad.size()), State::BAD_MAGIC);
+	bad = snapshot;
+	bad[4] ^= std::byte{0xFFU};
+	EXPECT_EQ(restore(bad, bad.size()), State::BAD_VERSION);
+	// First zone slot (a card in the first monster zone) says it has 2 cards.
+	bad = snapshot;
+	bad[sizeof(Detail::SnapshotHeader)] = std::byte{2U};
+	EXPECT_EQ(restore(bad, bad.size()), State::CORRUPTED);
+	bad = snapshot;
+	bad[offsetof(Detail::SnapshotHeader, reserved)] = std::byte{1U};
+	EXPECT_EQ(restore(bad, bad.size()), State::CORRUPTED);
+}
+
+TEST(SnapshotTest, OversizedSlotsAreCorrupted)
+{
+	// NOTE: Card records are all zeroes, as long as their count matches the
+	// slots' they are valid.
+	auto snapshot_with = [](size_t slot, uint32_t count)
+	{
+		Detail::SnapshotHeader header{};
+		header.magic = Detail::SNAPSHOT_MAGIC;
+		header.version = Detail::SNAPSHOT_VERSION;
+		header.card_count = count;
+		std::vector<uint32_t> counts(Detail::SNAPSHOT_SLOT_COUNT);
+		counts[slot] = count;
+		// Materials need a card in their zone.
+		if(slot != Detail::snapshot_slot(DECK))
+		{
+			counts[Detail::snapshot_slot(MZONE)] = 1U;
+			header.card_count++;
+		}
+		header.size = sizeof(header) + counts.size() * sizeof(uint32_t) +
+		              header.card_count * sizeof(Detail::SnapshotCard);
+		std::vector<std::byte> s(header.size);
+		std::memcpy(s.data(), &header, sizeof(header));
+		std::memcpy(s.data() + sizeof(header), counts.data(),
+		            counts.size() * sizeof(uint32_t));
+		return s;
+	};
+	auto restore = [](std::vector<std::byte> const& s)
+	{
+		BoardType b;
+		return restore_snapshot(b, s.data(), s.size()).state;
+	};
+	auto const materials = Detail::snapshot_slot(MATERIAL);
+	auto const deck = Detail::snapshot_slot(DECK);
+	EXPECT_EQ(restore(snapshot_with(materials, 0x8000U)), State::OK);
+	EXPECT_EQ(restore(snapshot_with(materials, 0x8001U)), State::CORRUPTED);
+	EXPECT_EQ(restore(snapshot_with(deck, 0x10000U)), State::OK);
+	EXPECT_EQ(restore(snapshot_with(deck, 0x10001U)), State::CORRUPTED);
+}
+
+} // namespace
@@ -48,6 +48,22 @@ TEST_F(UndoableTest, DirectlyEquallyComparable)
 	ASSERT_EQ(v, VALUE_1);
 }
 
+TEST_F(UndoableTest, SeekingWorks)
+{
+	auto const start = v.position();
+	v = VALUE_1;
+	v = VALUE_2;
+	auto const end = v.position();
+	v.seek(start);
+	ASSERT_EQ(int{v}, 0);
+	v = VALUE_1; // NOTE: Redoes the first assignment.
+	ASSERT_EQ(int{v}, VALUE_1);
+	v.seek(end);
+	ASSERT_EQ(int{v}, VALUE_2);
+	v.undo();
+	ASSERT_EQ(int{v}, VALUE_1);
+}
+
 TEST_F(UndoableTest, UndoCalledTooMuchDies)
 {
 	v = VALUE_1;
@@ -61,7 +77,38 @@ TEST_F(UndoableTest, UndoCalledTooMuchDies)
 
 TEST_F(UndoableTest, EraseHistoryWorks)
 {
-	// TODO
+	v = VALUE_1;
+	v = VALUE_2;
+	v.undo();
+	v.erase_history();
+	ASSERT_EQ(v.history_size(), 2U);
+	v = VALUE_2 + 1;
+	ASSERT_EQ(int{v}, VALUE_2 + 1);
+	v.undo();
+	ASSERT_EQ(int{v}, VALUE_1);
+}
+
+TEST_F(UndoableTest, HistoryLimitWorks)
+{
+	YGOpen::Client::BasicUndoable<int> u(3U);
+	for(int i = 1; i <= 10; i++)
+		u = i;
+	ASSERT_EQ(u.history_size(), 3U);
+	ASSERT_EQ(int{u}, 10);
+	auto const memory = u.memory_usage();
+	for(int i = 11; i <= 100; i++)
+		u = i;
+	ASSERT_EQ(u.memory_usage(), memory);
+	u.undo();
+	u.undo();
+	ASSERT_EQ(int{u}, 98);
+	EXPECT_DEATH(u.undo(), "");
+	// Lowering the limit forgets the oldest values first.
+	u.set_history_limit(1U);
+	ASSERT_EQ(int{u}, 98);
+	ASSERT_EQ(u.history_size(), 1U);
+	u = 1;
+	ASSERT_EQ(int{u}, 1);
 }
 
 } // namespace